@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::priority_queue;
+using std::string;
+using std::unordered_map;
+using std::unordered_set;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas, the last entry is the wait action
+const int delta[5][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}, {0, 0}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * Check that a cell is valid: on the grid and not an obstacle.
+ * The board is shared by all agents, so it is never marked closed.
+ */
+bool CheckValidCell(int x, int y, const vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] != State::kObstacle;
+    return false;
+}
+
+/**
+ * Time-indexed hash of the cells and moves claimed by already planned agents.
+ * An agent that has arrived stays parked on its goal from that time onwards.
+ */
+struct ReservationTable
+{
+    int rows;
+    int cols;
+    int horizon;                          // length of the longest reserved path
+    unordered_set<uint64_t> cells;        // (x, y, t) occupied
+    unordered_set<uint64_t> edges;        // (x1, y1) -> (x2, y2) between t and t + 1
+    unordered_map<int, int> parked;       // cell -> time from which it stays occupied
+    unordered_map<int, int> last_visited; // cell -> last time it is passed through
+};
+
+ReservationTable MakeReservationTable(const vector<vector<State>> &grid)
+{
+    ReservationTable table;
+    table.rows = grid.size();
+    table.cols = grid[0].size();
+    table.horizon = 0;
+    return table;
+}
+
+uint64_t CellKey(const ReservationTable &table, int x, int y, int t)
+{
+    return (static_cast<uint64_t>(t) * table.rows + x) * table.cols + y;
+}
+
+uint64_t EdgeKey(const ReservationTable &table, int x1, int y1, int x2, int y2, int t)
+{
+    // Four move directions plus wait fit in three bits.
+    int dir = 0;
+    while (x1 + delta[dir][0] != x2 || y1 + delta[dir][1] != y2)
+        dir++;
+    return CellKey(table, x1, y1, t) * 8 + dir;
+}
+
+/**
+ * Check whether (x, y) is occupied at time t by a previously planned agent.
+ */
+bool IsReserved(const ReservationTable &table, int x, int y, int t)
+{
+    auto park = table.parked.find(x * table.cols + y);
+    if (park != table.parked.end() && t >= park->second)
+        return true;
+    return table.cells.count(CellKey(table, x, y, t)) > 0;
+}
+
+/**
+ * Check whether moving (x1, y1) -> (x2, y2) between t and t + 1 collides
+ * with an agent doing the opposite move (a swap).
+ */
+bool IsEdgeReserved(const ReservationTable &table, int x1, int y1, int x2, int y2, int t)
+{
+    if (x1 == x2 && y1 == y2)
+        return false;
+    return table.edges.count(EdgeKey(table, x2, y2, x1, y1, t)) > 0;
+}
+
+/**
+ * Claim every cell and move along a path. The path holds one {x, y} per time step.
+ */
+void Reserve(ReservationTable &table, const vector<vector<int>> &path)
+{
+    for (int t = 0; t < path.size(); t++)
+    {
+        int x = path[t][0];
+        int y = path[t][1];
+        table.cells.insert(CellKey(table, x, y, t));
+        int &last = table.last_visited[x * table.cols + y];
+        last = std::max(last, t);
+        if (t + 1 < path.size())
+            table.edges.insert(EdgeKey(table, x, y, path[t + 1][0], path[t + 1][1], t));
+    }
+    table.parked[path.back()[0] * table.cols + path.back()[1]] = path.size() - 1;
+    table.horizon = std::max(table.horizon, static_cast<int>(path.size()));
+}
+
+/**
+ * Release everything Reserve claimed for a path, so the agent can be replanned.
+ */
+void Unreserve(ReservationTable &table, const vector<vector<int>> &path)
+{
+    for (int t = 0; t < path.size(); t++)
+    {
+        int x = path[t][0];
+        int y = path[t][1];
+        table.cells.erase(CellKey(table, x, y, t));
+        if (t + 1 < path.size())
+            table.edges.erase(EdgeKey(table, x, y, path[t + 1][0], path[t + 1][1], t));
+    }
+    table.parked.erase(path.back()[0] * table.cols + path.back()[1]);
+
+    // Other agents may still pass through the same cells.
+    for (const auto &step : path)
+    {
+        int cell = step[0] * table.cols + step[1];
+        int last = table.horizon - 1;
+        while (last >= 0 && !table.cells.count(CellKey(table, step[0], step[1], last)))
+            last--;
+        if (last < 0)
+            table.last_visited.erase(cell);
+        else
+            table.last_visited[cell] = last;
+    }
+}
+
+/**
+ * Order nodes {x, y, g, h} by f, preferring the deeper node on ties.
+ */
+struct CompareSpaceTime
+{
+    bool operator()(const vector<int> &a, const vector<int> &b) const
+    {
+        int f1 = a[2] + a[3];
+        int f2 = b[2] + b[3];
+        return f1 > f2 || (f1 == f2 && a[2] < b[2]);
+    }
+};
+
+using SpaceTimeOpen = priority_queue<vector<int>, vector<vector<int>>, CompareSpaceTime>;
+
+/**
+ * Expand current node's neighbors in space and time. Every action, including
+ * waiting in place, takes one time step, so g is also the node's time.
+ */
+void ExpandSpaceTimeNeighbors(const vector<int> &current, int goal[2], int max_t, SpaceTimeOpen &openlist,
+                              unordered_map<uint64_t, uint64_t> &parents, const vector<vector<State>> &grid,
+                              const ReservationTable &table)
+{
+    int x = current[0];
+    int y = current[1];
+    int g = current[2];
+    if (g >= max_t)
+        return;
+
+    for (int i = 0; i < 5; i++)
+    {
+        int x2 = x + delta[i][0];
+        int y2 = y + delta[i][1];
+        int g2 = g + 1;
+        if (!CheckValidCell(x2, y2, grid) || IsReserved(table, x2, y2, g2) || IsEdgeReserved(table, x, y, x2, y2, g))
+            continue;
+
+        // Each (x, y, t) state is opened at most once.
+        uint64_t key = CellKey(table, x2, y2, g2);
+        if (parents.count(key))
+            continue;
+        parents[key] = CellKey(table, x, y, g);
+        openlist.push(vector<int>{x2, y2, g2, Heuristic(x2, y2, goal[0], goal[1])});
+    }
+}
+
+/**
+ * Space-time A* for a single agent against the reservation table.
+ * Returns one {x, y} per time step, or an empty path if no plan fits in max_t steps.
+ */
+vector<vector<int>> SpaceTimeSearch(const vector<vector<State>> &grid, int init[2], int goal[2],
+                                    const ReservationTable &table, int max_t)
+{
+    SpaceTimeOpen open;
+    unordered_map<uint64_t, uint64_t> parents;
+    if (!CheckValidCell(init[0], init[1], grid) || IsReserved(table, init[0], init[1], 0))
+        return vector<vector<int>>{};
+
+    uint64_t root = CellKey(table, init[0], init[1], 0);
+    parents[root] = root;
+    open.push(vector<int>{init[0], init[1], 0, Heuristic(init[0], init[1], goal[0], goal[1])});
+
+    while (!open.empty())
+    {
+        auto current = open.top();
+        open.pop();
+        int x = current[0];
+        int y = current[1];
+        int t = current[2];
+
+        // The goal only counts if nobody passes through it after we park there.
+        if (x == goal[0] && y == goal[1])
+        {
+            auto last = table.last_visited.find(x * table.cols + y);
+            if (last == table.last_visited.end() || last->second < t)
+            {
+                vector<vector<int>> path(t + 1);
+                uint64_t key = CellKey(table, x, y, t);
+                for (int step = t; step >= 0; step--)
+                {
+                    int cell = key % (static_cast<uint64_t>(table.rows) * table.cols);
+                    path[step] = vector<int>{cell / table.cols, cell % table.cols};
+                    key = parents[key];
+                }
+                return path;
+            }
+        }
+
+        ExpandSpaceTimeNeighbors(current, goal, max_t, open, parents, grid, table);
+    }
+    return vector<vector<int>>{};
+}
+
+/**
+ * Plan all agents in priority order (index 0 first). Each agent is a
+ * {init_x, init_y, goal_x, goal_y} vector. An agent without a plan gets an
+ * empty path and stays parked at its start from t = 0, so its cell is
+ * reserved for good. Planned agents whose paths cross that cell are
+ * released and planned again after the others, which keeps every returned
+ * path free of collisions. Each failure parks one more agent for good, so
+ * the replanning always ends.
+ */
+vector<vector<vector<int>>> CooperativeSearch(const vector<vector<State>> &grid, const vector<vector<int>> &agents,
+                                              int max_t)
+{
+    ReservationTable table = MakeReservationTable(grid);
+    vector<vector<vector<int>>> paths(agents.size());
+    std::deque<int> pending;
+    for (int i = 0; i < agents.size(); i++)
+        pending.push_back(i);
+
+    while (!pending.empty())
+    {
+        int i = pending.front();
+        pending.pop_front();
+        int init[2]{agents[i][0], agents[i][1]};
+        int goal[2]{agents[i][2], agents[i][3]};
+        paths[i] = SpaceTimeSearch(grid, init, goal, table, max_t);
+        if (!paths[i].empty())
+        {
+            Reserve(table, paths[i]);
+            continue;
+        }
+
+        for (int j = 0; j < agents.size(); j++)
+        {
+            auto crosses = std::find(paths[j].begin(), paths[j].end(), vector<int>{init[0], init[1]});
+            if (crosses != paths[j].end())
+            {
+                Unreserve(table, paths[j]);
+                paths[j].clear();
+                pending.push_back(j);
+            }
+        }
+        // Park only after the release, which drops the parking of an agent
+        // whose goal is this start cell.
+        table.parked[init[0] * table.cols + init[1]] = 0;
+    }
+    return paths;
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+void PrintPath(const vector<vector<int>> &path)
+{
+    for (const auto &step : path)
+    {
+        cout << "(" << step[0] << "," << step[1] << ") ";
+    }
+    cout << "\n";
+}
+
+/**
+ * Build a square board with random obstacles and a set of agents with
+ * distinct starts and goals, each goal at most `radius` steps away.
+ */
+void RandomScenario(int n_agents, int side, int radius, std::mt19937 &rng, vector<vector<State>> &grid,
+                    vector<vector<int>> &agents)
+{
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    grid.assign(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < 0.1)
+                cell = State::kObstacle;
+
+    std::uniform_int_distribution<int> pos(0, side - 1);
+    std::uniform_int_distribution<int> offset(-radius, radius);
+    vector<bool> start_used(side * side, false), goal_used(side * side, false);
+    agents.clear();
+    while (agents.size() < n_agents)
+    {
+        int sx = pos(rng), sy = pos(rng);
+        int gx = sx + offset(rng), gy = sy + offset(rng);
+        if (!CheckValidCell(sx, sy, grid) || !CheckValidCell(gx, gy, grid) || start_used[sx * side + sy] ||
+            goal_used[gx * side + gy])
+            continue;
+        start_used[sx * side + sy] = true;
+        goal_used[gx * side + gy] = true;
+        agents.push_back(vector<int>{sx, sy, gx, gy});
+    }
+}
+
+/**
+ * Report planning throughput in agents per second for growing fleets.
+ */
+void BenchmarkCooperativeSearch()
+{
+    cout << "==========================================================\n";
+    cout << "Cooperative A* throughput\n";
+    std::mt19937 rng(42);
+    for (int n_agents : {100, 1000, 10000})
+    {
+        // Keep the density at roughly one agent per 25 cells.
+        int side = static_cast<int>(std::sqrt(n_agents * 25.0));
+        int radius = 20;
+        vector<vector<State>> grid;
+        vector<vector<int>> agents;
+        RandomScenario(n_agents, side, radius, rng, grid, agents);
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto paths = CooperativeSearch(grid, agents, 4 * radius);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        int planned = 0;
+        for (const auto &path : paths)
+            planned += !path.empty();
+        double seconds = std::chrono::duration<double>(t2 - t1).count();
+        cout << "Agents = " << n_agents << " Board = " << side << "x" << side << " Planned = " << planned
+             << " Time = " << seconds << " s Throughput = " << n_agents / seconds << " agents/s\n";
+    }
+}
+
+#include "test.cpp"
+
+int main()
+{
+    auto board = ReadBoardFile("../files/1.board");
+    // Two vehicles driving head-on through the open side of the board and one crossing both.
+    vector<vector<int>> agents{{0, 2, 4, 3}, {4, 3, 0, 2}, {0, 0, 4, 5}};
+    auto paths = CooperativeSearch(board, agents, 64);
+    for (int i = 0; i < paths.size(); i++)
+    {
+        cout << "Agent " << i << ": ";
+        PrintPath(paths[i]);
+    }
+    // Tests
+    TestReservationTable();
+    TestSpaceTimeSearchWaits();
+    TestCooperativeSearch();
+    TestFailedAgentIsParked();
+    BenchmarkCooperativeSearch();
+}
@@ -0,0 +1,200 @@
+void PrintVectorOfVectors(vector<vector<int>> v)
+{
+    for (auto row : v)
+    {
+        cout << "{ ";
+        for (auto col : row)
+        {
+            cout << col << " ";
+        }
+        cout << "}"
+             << "\n";
+    }
+}
+
+/**
+ * Check a set of timed paths for vertex and swap collisions, treating
+ * each agent as parked on its last cell once its path ends.
+ */
+bool HasCollision(const vector<vector<vector<int>>> &paths)
+{
+    int horizon = 0;
+    for (const auto &path : paths)
+        horizon = std::max(horizon, static_cast<int>(path.size()));
+
+    auto at = [](const vector<vector<int>> &path, int t) { return path[std::min(t, static_cast<int>(path.size()) - 1)]; };
+    for (int t = 0; t < horizon; t++)
+    {
+        for (int i = 0; i < paths.size(); i++)
+        {
+            for (int j = i + 1; j < paths.size(); j++)
+            {
+                if (at(paths[i], t) == at(paths[j], t))
+                    return true;
+                if (at(paths[i], t) == at(paths[j], t + 1) && at(paths[i], t + 1) == at(paths[j], t))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TestReservationTable()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ReservationTable Test: ";
+    vector<vector<State>> grid(3, vector<State>(3, State::kEmpty));
+    ReservationTable table = MakeReservationTable(grid);
+    Reserve(table, vector<vector<int>>{{0, 0}, {0, 1}, {1, 1}});
+
+    if (!IsReserved(table, 0, 1, 1) || IsReserved(table, 0, 1, 0) || IsReserved(table, 1, 1, 1))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Cells along the path are not reserved at the right times."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!IsReserved(table, 1, 1, 50))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The goal (1, 1) should stay reserved after arrival."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!IsEdgeReserved(table, 0, 1, 0, 0, 0) || IsEdgeReserved(table, 0, 0, 0, 1, 0))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Only the swap (0, 1) -> (0, 0) at t = 0 should be reserved."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSpaceTimeSearchWaits()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SpaceTimeSearch Wait Test: ";
+    // A one-lane corridor on top with a single side pocket at (1, 1).
+    vector<vector<State>> grid{{State::kEmpty, State::kEmpty, State::kEmpty},
+                               {State::kObstacle, State::kEmpty, State::kObstacle}};
+    ReservationTable table = MakeReservationTable(grid);
+    // Another vehicle pops into the corridor at t = 1 and goes back.
+    Reserve(table, vector<vector<int>>{{1, 1}, {0, 1}, {1, 1}});
+
+    int init[2]{0, 0};
+    int goal[2]{0, 2};
+    auto output = SpaceTimeSearch(grid, init, goal, table, 16);
+    vector<vector<int>> solution{{0, 0}, {0, 0}, {0, 1}, {0, 2}};
+
+    if (output != solution)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "SpaceTimeSearch(grid, {0,0}, {0,2})"
+             << "\n";
+        cout << "Solution path: "
+             << "\n";
+        PrintVectorOfVectors(solution);
+        cout << "Your path: "
+             << "\n";
+        PrintVectorOfVectors(output);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestCooperativeSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "CooperativeSearch Function Test: ";
+    auto board = ReadBoardFile("../files/1.board");
+    vector<vector<int>> agents{{0, 2, 4, 3}, {4, 3, 0, 2}, {0, 0, 4, 5}, {2, 5, 2, 2}};
+    auto paths = CooperativeSearch(board, agents, 64);
+
+    bool arrived = true;
+    for (int i = 0; i < agents.size(); i++)
+    {
+        if (paths[i].empty() || paths[i].back() != vector<int>{agents[i][2], agents[i][3]})
+            arrived = false;
+    }
+
+    if (!arrived)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Not every agent reached its goal."
+             << "\n";
+        cout << "\n";
+    }
+    else if (HasCollision(paths))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Planned paths collide:"
+             << "\n";
+        for (const auto &path : paths)
+            PrintVectorOfVectors(path);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
+
+void TestFailedAgentIsParked()
+{
+    cout << "CooperativeSearch Parked Agent Test: ";
+    // Agent 1 cannot reach its goal on the obstacle, so it stays at (0, 1),
+    // right on the shortest path of agent 0.
+    vector<vector<State>> grid(3, vector<State>(3, State::kEmpty));
+    grid[2][2] = State::kObstacle;
+    vector<vector<int>> agents{{0, 0, 0, 2}, {0, 1, 2, 2}};
+    auto paths = CooperativeSearch(grid, agents, 16);
+
+    bool crosses = std::find(paths[0].begin(), paths[0].end(), vector<int>{0, 1}) != paths[0].end();
+    if (!paths[1].empty() || paths[0].empty() || paths[0].back() != vector<int>{0, 2} || crosses)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Agent 0 should drive around the parked agent 1:"
+             << "\n";
+        PrintVectorOfVectors(paths[0]);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
@@ -0,0 +1,609 @@
+#include <algorithm> // for sort
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::sort;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+/**
+ * Connected-component label of every cell of a board. Obstacles are
+ * labelled -1; two empty cells are connected iff their labels match.
+ */
+struct ComponentLabels
+{
+    int rows;
+    int cols;
+    vector<int> label;  // per cell, indexed x * cols + y
+    vector<int> size;   // number of cells per label
+    vector<int> unused; // labels of size 0, reused before size grows
+};
+
+/**
+ * Take an unused label for a new component of `count` cells. Labels are
+ * recycled, so toggling obstacles never grows the table past one label per cell.
+ */
+int NewLabel(ComponentLabels &labels, int count)
+{
+    int l;
+    if (labels.unused.empty())
+    {
+        l = labels.size.size();
+        labels.size.push_back(0);
+    }
+    else
+    {
+        l = labels.unused.back();
+        labels.unused.pop_back();
+    }
+    labels.size[l] = count;
+    return l;
+}
+
+int FindRoot(vector<int> &parent, int i)
+{
+    // Path halving keeps the trees flat without recursion.
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+int FindRootNoCompress(const vector<int> &parent, int i)
+{
+    while (parent[i] != i)
+        i = parent[i];
+    return i;
+}
+
+void Union(vector<int> &parent, int a, int b)
+{
+    int ra = FindRoot(parent, a);
+    int rb = FindRoot(parent, b);
+    // Link the larger index under the smaller one so roots stay deterministic.
+    if (ra < rb)
+        parent[rb] = ra;
+    else if (rb < ra)
+        parent[ra] = rb;
+}
+
+/**
+ * Union the empty cells of rows [row_begin, row_end) with their left and upper
+ * neighbors inside the band. Bands touch disjoint parts of `parent`.
+ */
+void UnionBand(const vector<vector<State>> &grid, int row_begin, int row_end, vector<int> &parent)
+{
+    int cols = grid[0].size();
+    for (int x = row_begin; x < row_end; x++)
+    {
+        for (int y = 0; y < cols; y++)
+        {
+            if (grid[x][y] == State::kObstacle)
+                continue;
+            int i = x * cols + y;
+            if (y > 0 && grid[x][y - 1] != State::kObstacle)
+                Union(parent, i, i - 1);
+            if (x > row_begin && grid[x - 1][y] != State::kObstacle)
+                Union(parent, i, i - cols);
+        }
+    }
+}
+
+/**
+ * Label the connected components of a board with a parallel union-find:
+ * every thread merges a band of rows, then the band seams are stitched.
+ */
+ComponentLabels LabelComponents(const vector<vector<State>> &grid, int n_threads = std::thread::hardware_concurrency())
+{
+    int rows = grid.size();
+    int cols = grid[0].size();
+    int n = rows * cols;
+    n_threads = std::max(1, std::min(n_threads, rows));
+
+    vector<int> parent(n);
+    for (int i = 0; i < n; i++)
+        parent[i] = i;
+
+    vector<int> band_begin;
+    for (int b = 0; b <= n_threads; b++)
+        band_begin.push_back(b * rows / n_threads);
+
+    vector<std::thread> threads;
+    for (int b = 0; b < n_threads; b++)
+        threads.emplace_back(UnionBand, std::cref(grid), band_begin[b], band_begin[b + 1], std::ref(parent));
+    for (auto &t : threads)
+        t.join();
+
+    // Stitch the first row of every band to the last row of the band above.
+    for (int b = 1; b < n_threads; b++)
+    {
+        int x = band_begin[b];
+        for (int y = 0; y < cols; y++)
+        {
+            if (grid[x][y] != State::kObstacle && grid[x - 1][y] != State::kObstacle)
+                Union(parent, x * cols + y, (x - 1) * cols + y);
+        }
+    }
+
+    // The forest is final, so the bands can be flattened concurrently read-only.
+    ComponentLabels labels{rows, cols, vector<int>(n, -1), vector<int>(n, 0), vector<int>()};
+    threads.clear();
+    for (int b = 0; b < n_threads; b++)
+    {
+        threads.emplace_back([&, b]() {
+            for (int i = band_begin[b] * cols; i < band_begin[b + 1] * cols; i++)
+            {
+                if (grid[i / cols][i % cols] != State::kObstacle)
+                    labels.label[i] = FindRootNoCompress(parent, i);
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    for (int i = 0; i < n; i++)
+    {
+        if (labels.label[i] >= 0)
+            labels.size[labels.label[i]]++;
+    }
+    for (int l = n - 1; l >= 0; l--)
+    {
+        if (labels.size[l] == 0)
+            labels.unused.push_back(l);
+    }
+    return labels;
+}
+
+/**
+ * O(1) check whether two cells can be connected by a path.
+ */
+bool SameComponent(const ComponentLabels &labels, int x1, int y1, int x2, int y2)
+{
+    int a = labels.label[x1 * labels.cols + y1];
+    int b = labels.label[x2 * labels.cols + y2];
+    return a >= 0 && a == b;
+}
+
+/**
+ * Flood fill from cell `start` across cells labelled `from`, relabelling them to `to`.
+ */
+void Relabel(ComponentLabels &labels, int start, int from, int to)
+{
+    vector<int> stack{start};
+    labels.label[start] = to;
+    while (!stack.empty())
+    {
+        int i = stack.back();
+        stack.pop_back();
+        int x = i / labels.cols;
+        int y = i % labels.cols;
+        for (auto d : delta)
+        {
+            int x2 = x + d[0];
+            int y2 = y + d[1];
+            if (x2 < 0 || x2 >= labels.rows || y2 < 0 || y2 >= labels.cols)
+                continue;
+            int j = x2 * labels.cols + y2;
+            if (labels.label[j] == from)
+            {
+                labels.label[j] = to;
+                stack.push_back(j);
+            }
+        }
+    }
+    labels.size[to] += labels.size[from];
+    labels.size[from] = 0;
+    labels.unused.push_back(from);
+}
+
+/**
+ * Clear an obstacle and merge the components it now connects. Smaller
+ * components are relabelled into the largest one (union by size).
+ */
+void RemoveObstacle(vector<vector<State>> &grid, ComponentLabels &labels, int x, int y)
+{
+    if (grid[x][y] != State::kObstacle)
+        return;
+    grid[x][y] = State::kEmpty;
+
+    int cell = x * labels.cols + y;
+    int largest = -1;
+    for (auto d : delta)
+    {
+        int x2 = x + d[0];
+        int y2 = y + d[1];
+        if (x2 < 0 || x2 >= labels.rows || y2 < 0 || y2 >= labels.cols)
+            continue;
+        int l = labels.label[x2 * labels.cols + y2];
+        if (l >= 0 && (largest < 0 || labels.size[l] > labels.size[largest]))
+            largest = l;
+    }
+
+    if (largest < 0)
+    {
+        labels.label[cell] = NewLabel(labels, 1);
+        return;
+    }
+    labels.label[cell] = largest;
+    labels.size[largest]++;
+    for (auto d : delta)
+    {
+        int x2 = x + d[0];
+        int y2 = y + d[1];
+        if (x2 < 0 || x2 >= labels.rows || y2 < 0 || y2 >= labels.cols)
+            continue;
+        int j = x2 * labels.cols + y2;
+        if (labels.label[j] >= 0 && labels.label[j] != largest)
+            Relabel(labels, j, labels.label[j], largest);
+    }
+}
+
+/**
+ * Place an obstacle and split its component if the cell was a bridge.
+ * One flood fill per empty neighbor runs in lockstep; fills that meet are
+ * merged, and a fill that runs dry while others are still open has found a
+ * separated piece, which gets a fresh label. The last open fill keeps the old
+ * label, so the work is bounded by the size of the pieces that split off.
+ */
+void AddObstacle(vector<vector<State>> &grid, ComponentLabels &labels, int x, int y)
+{
+    if (grid[x][y] == State::kObstacle)
+        return;
+    grid[x][y] = State::kObstacle;
+
+    int cell = x * labels.cols + y;
+    int old = labels.label[cell];
+    labels.label[cell] = -1;
+    if (--labels.size[old] == 0)
+        labels.unused.push_back(old);
+
+    vector<int> sources;
+    for (auto d : delta)
+    {
+        int x2 = x + d[0];
+        int y2 = y + d[1];
+        if (x2 >= 0 && x2 < labels.rows && y2 >= 0 && y2 < labels.cols && labels.label[x2 * labels.cols + y2] == old)
+            sources.push_back(x2 * labels.cols + y2);
+    }
+    if (sources.size() < 2)
+        return;
+
+    // owner[] maps a visited cell to its fill; group[] merges fills that met.
+    int k = sources.size();
+    unordered_map<int, int> owner;
+    vector<int> group(k);
+    vector<vector<int>> frontier(k), visited(k);
+    for (int s = 0; s < k; s++)
+    {
+        group[s] = s;
+        frontier[s].push_back(sources[s]);
+        visited[s].push_back(sources[s]);
+        owner[sources[s]] = s;
+    }
+    auto root = [&](int s) {
+        while (s >= 0 && group[s] != s)
+            s = group[s];
+        return s;
+    };
+    auto open_groups = [&]() {
+        int count = 0;
+        for (int s = 0; s < k; s++)
+            count += (group[s] == s);
+        return count;
+    };
+
+    while (open_groups() > 1)
+    {
+        for (int s = 0; s < k; s++)
+        {
+            if (group[s] != s)
+                continue;
+            if (frontier[s].empty())
+            {
+                // Separated piece: give it a fresh label.
+                int fresh = NewLabel(labels, visited[s].size());
+                labels.size[old] -= visited[s].size();
+                for (int i : visited[s])
+                    labels.label[i] = fresh;
+                group[s] = -1;
+                break;
+            }
+            int i = frontier[s].back();
+            frontier[s].pop_back();
+            for (auto d : delta)
+            {
+                int x2 = i / labels.cols + d[0];
+                int y2 = i % labels.cols + d[1];
+                if (x2 < 0 || x2 >= labels.rows || y2 < 0 || y2 >= labels.cols)
+                    continue;
+                int j = x2 * labels.cols + y2;
+                if (labels.label[j] != old)
+                    continue;
+                auto seen = owner.find(j);
+                if (seen == owner.end())
+                {
+                    owner[j] = s;
+                    frontier[s].push_back(j);
+                    visited[s].push_back(j);
+                }
+                else if (root(seen->second) != s && root(seen->second) >= 0)
+                {
+                    // Two fills met: fold the other one into this fill.
+                    int other = root(seen->second);
+                    group[other] = s;
+                    frontier[s].insert(frontier[s].end(), frontier[other].begin(), frontier[other].end());
+                    visited[s].insert(visited[s].end(), visited[other].begin(), visited[other].end());
+                    frontier[other].clear();
+                    visited[other].clear();
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Compare the F values of two cells.
+ */
+bool Compare(const vector<int> a, const vector<int> b)
+{
+    int f1 = a[2] + a[3]; // f1 = g1 + h1
+    int f2 = b[2] + b[3]; // f2 = g2 + h2
+    return f1 > f2;
+}
+
+/**
+ * Sort the two-dimensional vector of ints in descending order.
+ */
+void CellSort(vector<vector<int>> *v)
+{
+    sort(v->begin(), v->end(), Compare);
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * Check that a cell is valid: on the grid, not an obstacle, and clear.
+ */
+bool CheckValidCell(int x, int y, vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] == State::kEmpty;
+    return false;
+}
+
+/**
+ * Add a node to the open list and mark it as open.
+ */
+void AddToOpen(int x, int y, int g, int h, vector<vector<int>> &openlist, vector<vector<State>> &grid)
+{
+    // Add node to open vector, and mark grid cell as closed.
+    openlist.push_back(vector<int>{x, y, g, h});
+    grid[x][y] = State::kClosed;
+}
+
+/**
+ * Expand current nodes's neighbors and add them to the open list.
+ */
+void ExpandNeighbors(const vector<int> &current, int goal[2], vector<vector<int>> &openlist, vector<vector<State>> &grid)
+{
+    // Get current node's data.
+    int x = current[0];
+    int y = current[1];
+    int g = current[2];
+
+    // Loop through current node's potential neighbors.
+    for (int i = 0; i < 4; i++)
+    {
+        int x2 = x + delta[i][0];
+        int y2 = y + delta[i][1];
+
+        // Check that the potential neighbor's x2 and y2 values are on the grid and not closed.
+        if (CheckValidCell(x2, y2, grid))
+        {
+            // Increment g value and add neighbor to open list.
+            int g2 = g + 1;
+            int h2 = Heuristic(x2, y2, goal[0], goal[1]);
+            AddToOpen(x2, y2, g2, h2, openlist, grid);
+        }
+    }
+}
+
+/**
+ * Implementation of A* search algorithm. When component labels are given,
+ * a goal in another component is rejected before any node is expanded.
+ */
+vector<vector<State>> Search(vector<vector<State>> grid, int init[2], int goal[2],
+                             const ComponentLabels *labels = nullptr)
+{
+    if (labels != nullptr && !SameComponent(*labels, init[0], init[1], goal[0], goal[1]))
+    {
+        cout << "No path found!"
+             << "\n";
+        return std::vector<vector<State>>{};
+    }
+
+    // Create the vector of open nodes.
+    vector<vector<int>> open{};
+
+    // Initialize the starting node.
+    int x = init[0];
+    int y = init[1];
+    int g = 0;
+    int h = Heuristic(x, y, goal[0], goal[1]);
+    AddToOpen(x, y, g, h, open, grid);
+
+    while (open.size() > 0)
+    {
+        // Get the next node
+        CellSort(&open);
+        auto current = open.back();
+        open.pop_back();
+        x = current[0];
+        y = current[1];
+        grid[x][y] = State::kPath;
+
+        // Check if we're done.
+        if (x == goal[0] && y == goal[1])
+        {
+            grid[init[0]][init[1]] = State::kStart;
+            grid[goal[0]][goal[1]] = State::kFinish;
+            return grid;
+        }
+
+        // If we're not done, expand search to current node's neighbors.
+        ExpandNeighbors(current, goal, open, grid);
+    }
+
+    // We've run out of new nodes to explore and haven't found a path.
+    cout << "No path found!"
+         << "\n";
+    return std::vector<vector<State>>{};
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Time an unreachable query on a large board split by a wall, with and
+ * without the component labels.
+ */
+void BenchmarkUnreachableGoal()
+{
+    cout << "==========================================================\n";
+    cout << "Unreachable goal latency\n";
+    int side = 60;
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (int y = 0; y < side; y++)
+        board[side - 2][y] = State::kObstacle;
+    int init[2]{0, 0};
+    int goal[2]{side - 1, side - 1};
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto labels = LabelComponents(board);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    Search(board, init, goal, &labels);
+    auto t3 = std::chrono::high_resolution_clock::now();
+    Search(board, init, goal);
+    auto t4 = std::chrono::high_resolution_clock::now();
+    std::cout.clear(); // Enable cout
+
+    auto us = [](std::chrono::high_resolution_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    cout << "Labelling " << side << "x" << side << " board = " << us(t2 - t1) << " microseconds\n";
+    cout << "Search with labels = " << us(t3 - t2) << " microseconds\n";
+    cout << "Search without labels = " << us(t4 - t3) << " microseconds\n";
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto labels = LabelComponents(board);
+    auto solution = Search(board, init, goal, &labels);
+    PrintBoard(solution);
+    // Tests
+    TestLabelComponents();
+    TestSearchUnreachable();
+    TestAddObstacle();
+    TestRemoveObstacle();
+    BenchmarkUnreachableGoal();
+}
@@ -0,0 +1,215 @@
+void PrintVectorOfVectors(vector<vector<State>> v)
+{
+    for (auto row : v)
+    {
+        cout << "{ ";
+        for (auto col : row)
+        {
+            cout << CellString(col) << " ";
+        }
+        cout << "}"
+             << "\n";
+    }
+}
+
+/**
+ * Two labellings describe the same components if their labels map one to one.
+ */
+bool SamePartition(const ComponentLabels &a, const ComponentLabels &b)
+{
+    unordered_map<int, int> a_to_b, b_to_a;
+    for (int i = 0; i < a.label.size(); i++)
+    {
+        int la = a.label[i];
+        int lb = b.label[i];
+        if ((la < 0) != (lb < 0))
+            return false;
+        if (la < 0)
+            continue;
+        if (a_to_b.count(la) && a_to_b[la] != lb)
+            return false;
+        if (b_to_a.count(lb) && b_to_a[lb] != la)
+            return false;
+        a_to_b[la] = lb;
+        b_to_a[lb] = la;
+    }
+    return true;
+}
+
+// A 3x5 board whose two halves are joined only through (1, 2).
+vector<vector<State>> BridgeBoard()
+{
+    vector<vector<State>> grid(3, vector<State>(5, State::kEmpty));
+    grid[0][2] = State::kObstacle;
+    grid[2][2] = State::kObstacle;
+    return grid;
+}
+
+void TestLabelComponents()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "LabelComponents Function Test: ";
+    auto board = ReadBoardFile("../files/1.board");
+    auto labels = LabelComponents(board, 3);
+    auto split = BridgeBoard();
+    split[1][2] = State::kObstacle;
+    auto split_labels = LabelComponents(split, 3);
+
+    if (!SameComponent(labels, 0, 0, 4, 5) || SameComponent(labels, 0, 0, 0, 1))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Test grid is: "
+             << "\n";
+        PrintVectorOfVectors(board);
+        cout << "Cells (0, 0) and (4, 5) should share a component, obstacle (0, 1) should not."
+             << "\n";
+        cout << "\n";
+    }
+    else if (SameComponent(split_labels, 0, 0, 0, 4) || !SameComponent(split_labels, 0, 0, 2, 1))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Test grid is: "
+             << "\n";
+        PrintVectorOfVectors(split);
+        cout << "The left and right halves should be separate components."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchUnreachable()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Search Unreachable Goal Test: ";
+    auto board = BridgeBoard();
+    board[1][2] = State::kObstacle;
+    auto labels = LabelComponents(board);
+    int init[2]{0, 0};
+    int goal[2]{2, 4};
+
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    auto output = Search(board, init, goal, &labels);
+    std::cout.clear(); // Enable cout
+
+    if (!output.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "Search(board, {0,0}, {2,4}) should return an empty board, got: "
+             << "\n";
+        PrintVectorOfVectors(output);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestAddObstacle()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "AddObstacle Function Test: ";
+    auto board = BridgeBoard();
+    auto labels = LabelComponents(board);
+    AddObstacle(board, labels, 1, 2);
+
+    if (SameComponent(labels, 0, 0, 0, 4) || !SamePartition(labels, LabelComponents(board)))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Blocking the bridge (1, 2) should split the board: "
+             << "\n";
+        PrintVectorOfVectors(board);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestRemoveObstacle()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "RemoveObstacle Function Test: ";
+    auto board = BridgeBoard();
+    board[1][2] = State::kObstacle;
+    auto labels = LabelComponents(board);
+    RemoveObstacle(board, labels, 1, 2);
+
+    // Random toggles on a larger board must match a full relabel every time.
+    std::srand(7);
+    vector<vector<State>> big(20, vector<State>(20, State::kEmpty));
+    auto big_labels = LabelComponents(big);
+    bool consistent = true;
+    for (int step = 0; step < 2000 && consistent; step++)
+    {
+        int x = std::rand() % 20;
+        int y = std::rand() % 20;
+        if (big[x][y] == State::kObstacle)
+            RemoveObstacle(big, big_labels, x, y);
+        else
+            AddObstacle(big, big_labels, x, y);
+        consistent = SamePartition(big_labels, LabelComponents(big));
+    }
+    // Freed labels are reused, so there is never more than one per cell.
+    bool bounded = big_labels.size.size() == 20 * 20;
+
+    if (!SameComponent(labels, 0, 0, 0, 4) || !SamePartition(labels, LabelComponents(board)))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Clearing the bridge (1, 2) should join the board: "
+             << "\n";
+        PrintVectorOfVectors(board);
+        cout << "\n";
+    }
+    else if (!consistent)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Incremental labels diverged from a full relabel on: "
+             << "\n";
+        PrintVectorOfVectors(big);
+        cout << "\n";
+    }
+    else if (!bounded)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The label table grew to " << big_labels.size.size() << " entries for 400 cells."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
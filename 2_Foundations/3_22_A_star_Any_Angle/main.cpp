@@ -0,0 +1,494 @@
+#include <algorithm> // for sort
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::sort;
+using std::string;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+/**
+ * Compare the F values of two cells.
+ */
+bool Compare(const vector<int> a, const vector<int> b)
+{
+    int f1 = a[2] + a[3]; // f1 = g1 + h1
+    int f2 = b[2] + b[3]; // f2 = g2 + h2
+    return f1 > f2;
+}
+
+/**
+ * Sort the two-dimensional vector of ints in descending order.
+ */
+void CellSort(vector<vector<int>> *v)
+{
+    sort(v->begin(), v->end(), Compare);
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+// Calculate the straight line distance between two cell centers
+double Distance(int x1, int y1, int x2, int y2)
+{
+    return std::hypot(x2 - x1, y2 - y1);
+}
+
+/**
+ * Check that a cell is valid: on the grid, not an obstacle, and clear.
+ */
+bool CheckValidCell(int x, int y, vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] == State::kEmpty;
+    return false;
+}
+
+/**
+ * Check that a cell is on the grid and not an obstacle.
+ */
+bool IsFree(int x, int y, const vector<vector<State>> &grid)
+{
+    return x >= 0 && x < grid.size() && y >= 0 && y < grid[0].size() && grid[x][y] != State::kObstacle;
+}
+
+/**
+ * Bresenham line of sight between two cell centers. Only the cells of the
+ * rasterized line are tested, so it may cut the corner between two obstacles.
+ */
+bool LineOfSightBresenham(const vector<vector<State>> &grid, int x0, int y0, int x1, int y1)
+{
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true)
+    {
+        if (grid[x0][y0] == State::kObstacle)
+            return false;
+        if (x0 == x1 && y0 == y1)
+            return true;
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+/**
+ * Supercover line of sight between two cell centers: every cell the segment
+ * touches must be free. When the segment passes exactly through a corner,
+ * both cells beside the corner are checked so a vehicle cannot squeeze between them.
+ */
+bool LineOfSight(const vector<vector<State>> &grid, int x0, int y0, int x1, int y1)
+{
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int error = dx - dy;
+    dx *= 2;
+    dy *= 2;
+    for (int n = 1 + abs(x1 - x0) + abs(y1 - y0); n > 0; n--)
+    {
+        if (grid[x0][y0] == State::kObstacle)
+            return false;
+        if (error > 0)
+        {
+            x0 += sx;
+            error -= dy;
+        }
+        else if (error < 0)
+        {
+            y0 += sy;
+            error += dx;
+        }
+        else
+        {
+            if (n == 1)
+                break;
+            if (grid[x0 + sx][y0] == State::kObstacle || grid[x0][y0 + sy] == State::kObstacle)
+                return false;
+            x0 += sx;
+            y0 += sy;
+            error += dx - dy;
+            n--;
+        }
+    }
+    return true;
+}
+
+using SightCheck = bool (*)(const vector<vector<State>> &, int, int, int, int);
+
+/**
+ * Add a node to the open list, remember where it came from, and mark it as open.
+ */
+void AddToOpen(int x, int y, int g, int h, int parent, vector<vector<int>> &openlist, vector<int> &parents,
+               vector<vector<State>> &grid)
+{
+    openlist.push_back(vector<int>{x, y, g, h});
+    parents[x * grid[0].size() + y] = parent;
+    grid[x][y] = State::kClosed;
+}
+
+/**
+ * Expand current nodes's neighbors and add them to the open list.
+ */
+void ExpandNeighbors(const vector<int> &current, int goal[2], vector<vector<int>> &openlist, vector<int> &parents,
+                     vector<vector<State>> &grid)
+{
+    // Get current node's data.
+    int x = current[0];
+    int y = current[1];
+    int g = current[2];
+
+    // Loop through current node's potential neighbors.
+    for (int i = 0; i < 4; i++)
+    {
+        int x2 = x + delta[i][0];
+        int y2 = y + delta[i][1];
+
+        // Check that the potential neighbor's x2 and y2 values are on the grid and not closed.
+        if (CheckValidCell(x2, y2, grid))
+        {
+            // Increment g value and add neighbor to open list.
+            int g2 = g + 1;
+            int h2 = Heuristic(x2, y2, goal[0], goal[1]);
+            AddToOpen(x2, y2, g2, h2, x * grid[0].size() + y, openlist, parents, grid);
+        }
+    }
+}
+
+/**
+ * Follow the parent links from the goal back to the start.
+ */
+vector<vector<int>> TracePath(const vector<int> &parents, int cols, int goal[2])
+{
+    vector<vector<int>> path;
+    int cell = goal[0] * cols + goal[1];
+    while (true)
+    {
+        path.push_back(vector<int>{cell / cols, cell % cols});
+        if (parents[cell] == cell)
+            break;
+        cell = parents[cell];
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * A* search returning the 4-connected path as a list of {x, y} cells.
+ */
+vector<vector<int>> SearchPath(vector<vector<State>> grid, int init[2], int goal[2])
+{
+    vector<vector<int>> open{};
+    vector<int> parents(grid.size() * grid[0].size(), -1);
+
+    int x = init[0];
+    int y = init[1];
+    AddToOpen(x, y, 0, Heuristic(x, y, goal[0], goal[1]), x * grid[0].size() + y, open, parents, grid);
+
+    while (open.size() > 0)
+    {
+        CellSort(&open);
+        auto current = open.back();
+        open.pop_back();
+        x = current[0];
+        y = current[1];
+        grid[x][y] = State::kPath;
+
+        if (x == goal[0] && y == goal[1])
+            return TracePath(parents, grid[0].size(), goal);
+
+        ExpandNeighbors(current, goal, open, parents, grid);
+    }
+
+    cout << "No path found!"
+         << "\n";
+    return vector<vector<int>>{};
+}
+
+/**
+ * Post-process a path by string pulling: from each kept waypoint, jump to the
+ * farthest later waypoint that is still in line of sight.
+ */
+vector<vector<int>> SmoothPath(const vector<vector<State>> &grid, const vector<vector<int>> &path,
+                               SightCheck sight = LineOfSight)
+{
+    if (path.size() < 3)
+        return path;
+
+    vector<vector<int>> smooth{path.front()};
+    int anchor = 0;
+    while (anchor < path.size() - 1)
+    {
+        int next = anchor + 1;
+        for (int j = path.size() - 1; j > anchor + 1; j--)
+        {
+            if (sight(grid, path[anchor][0], path[anchor][1], path[j][0], path[j][1]))
+            {
+                next = j;
+                break;
+            }
+        }
+        smooth.push_back(path[next]);
+        anchor = next;
+    }
+    return smooth;
+}
+
+/**
+ * Theta*: A* over the same 4-connected neighbors, except that a neighbor may
+ * take its parent's parent as its own parent when the two see each other, so
+ * the waypoints are joined by any-angle segments.
+ */
+vector<vector<int>> ThetaStarSearch(const vector<vector<State>> &grid, int init[2], int goal[2])
+{
+    int cols = grid[0].size();
+    int n = grid.size() * cols;
+    vector<double> g(n, INFINITY);
+    vector<int> parents(n, -1);
+    vector<bool> closed(n, false);
+
+    // Open entries are {f, cell}; stale entries are skipped when popped.
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry>> open;
+
+    int start = init[0] * cols + init[1];
+    g[start] = 0;
+    parents[start] = start;
+    open.push(Entry{Distance(init[0], init[1], goal[0], goal[1]), start});
+
+    while (!open.empty())
+    {
+        int cell = open.top().second;
+        open.pop();
+        if (closed[cell])
+            continue;
+        closed[cell] = true;
+
+        int x = cell / cols;
+        int y = cell % cols;
+        if (x == goal[0] && y == goal[1])
+            return TracePath(parents, cols, goal);
+
+        int px = parents[cell] / cols;
+        int py = parents[cell] % cols;
+        for (auto d : delta)
+        {
+            int x2 = x + d[0];
+            int y2 = y + d[1];
+            if (!IsFree(x2, y2, grid))
+                continue;
+            int next = x2 * cols + y2;
+            if (closed[next])
+                continue;
+
+            // Path 2 straight from the grandparent, else path 1 through this cell.
+            int parent = cell;
+            double g2 = g[cell] + 1;
+            if (LineOfSight(grid, px, py, x2, y2))
+            {
+                parent = parents[cell];
+                g2 = g[parent] + Distance(px, py, x2, y2);
+            }
+            if (g2 < g[next])
+            {
+                g[next] = g2;
+                parents[next] = parent;
+                open.push(Entry{g2 + Distance(x2, y2, goal[0], goal[1]), next});
+            }
+        }
+    }
+
+    cout << "No path found!"
+         << "\n";
+    return vector<vector<int>>{};
+}
+
+// Length of a waypoint path when driving straight between the waypoints
+double PathLength(const vector<vector<int>> &path)
+{
+    double length = 0;
+    for (int i = 1; i < path.size(); i++)
+        length += Distance(path[i - 1][0], path[i - 1][1], path[i][0], path[i][1]);
+    return length;
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Mark the waypoints of a path on a copy of the board.
+ */
+vector<vector<State>> DrawPath(vector<vector<State>> grid, const vector<vector<int>> &path)
+{
+    for (const auto &p : path)
+        grid[p[0]][p[1]] = State::kPath;
+    grid[path.front()[0]][path.front()[1]] = State::kStart;
+    grid[path.back()[0]][path.back()[1]] = State::kFinish;
+    return grid;
+}
+
+/**
+ * Time both line-of-sight kernels on random segments of a large board.
+ */
+void BenchmarkLineOfSight()
+{
+    cout << "==========================================================\n";
+    cout << "Line of sight kernels\n";
+    int side = 512;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < 0.02)
+                cell = State::kObstacle;
+
+    int n_checks = 1000000;
+    std::uniform_int_distribution<int> pos(0, side - 1);
+    std::uniform_int_distribution<int> offset(-32, 32);
+    vector<int> segments;
+    while (segments.size() < 4 * n_checks)
+    {
+        int x0 = pos(rng), y0 = pos(rng);
+        int x1 = x0 + offset(rng), y1 = y0 + offset(rng);
+        if (x1 < 0 || x1 >= side || y1 < 0 || y1 >= side)
+            continue;
+        segments.insert(segments.end(), {x0, y0, x1, y1});
+    }
+
+    vector<std::pair<string, SightCheck>> kernels{{"Bresenham", LineOfSightBresenham}, {"Supercover", LineOfSight}};
+    for (const auto &kernel : kernels)
+    {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        int visible = 0;
+        for (int i = 0; i < segments.size(); i += 4)
+            visible += kernel.second(grid, segments[i], segments[i + 1], segments[i + 2], segments[i + 3]);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / n_checks;
+        cout << kernel.first << ": " << ns << " ns/check, " << visible << " of " << n_checks << " visible\n";
+    }
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto path = SearchPath(board, init, goal);
+    auto smooth = SmoothPath(board, path);
+    auto theta = ThetaStarSearch(board, init, goal);
+    cout << "A* waypoints = " << path.size() << " length = " << PathLength(path) << "\n";
+    cout << "Smoothed waypoints = " << smooth.size() << " length = " << PathLength(smooth) << "\n";
+    cout << "Theta* waypoints = " << theta.size() << " length = " << PathLength(theta) << "\n";
+    PrintBoard(DrawPath(board, theta));
+    // Tests
+    TestLineOfSight();
+    TestSearchPath();
+    TestSmoothPath();
+    TestThetaStarSearch();
+    BenchmarkLineOfSight();
+}
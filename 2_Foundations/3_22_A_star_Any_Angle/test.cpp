@@ -0,0 +1,171 @@
+void PrintVectorOfVectors(vector<vector<int>> v)
+{
+    for (auto row : v)
+    {
+        cout << "{ ";
+        for (auto col : row)
+        {
+            cout << col << " ";
+        }
+        cout << "}"
+             << "\n";
+    }
+}
+
+/**
+ * A waypoint path is drivable if it joins init to goal and every leg is in line of sight.
+ */
+bool IsDrivable(const vector<vector<State>> &grid, const vector<vector<int>> &path, int init[2], int goal[2])
+{
+    if (path.empty() || path.front() != vector<int>{init[0], init[1]} || path.back() != vector<int>{goal[0], goal[1]})
+        return false;
+    for (int i = 1; i < path.size(); i++)
+    {
+        if (!LineOfSight(grid, path[i - 1][0], path[i - 1][1], path[i][0], path[i][1]))
+            return false;
+    }
+    return true;
+}
+
+void TestLineOfSight()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "LineOfSight Function Test: ";
+    auto board = ReadBoardFile("../files/1.board");
+    // Two obstacles touching at a corner.
+    vector<vector<State>> corner{{State::kEmpty, State::kObstacle},
+                                 {State::kObstacle, State::kEmpty}};
+
+    if (!LineOfSight(board, 0, 2, 4, 3) || LineOfSight(board, 0, 0, 0, 2) || LineOfSight(board, 4, 3, 3, 5))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Expected sight (0, 2) -> (4, 3) and no sight (0, 0) -> (0, 2) or (4, 3) -> (3, 5)."
+             << "\n";
+        cout << "\n";
+    }
+    else if (LineOfSight(corner, 0, 0, 1, 1) || !LineOfSightBresenham(corner, 0, 0, 1, 1))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Supercover should block the diagonal between two touching obstacles, Bresenham should not."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchPath()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SearchPath Function Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto output = SearchPath(board, init, goal);
+    vector<vector<int>> solution{{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {4, 1}, {4, 2},
+                                 {4, 3}, {3, 3}, {3, 4}, {3, 5}, {4, 5}};
+
+    if (output.size() != solution.size() || !IsDrivable(board, output, init, goal))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "SearchPath(board, {0,0}, {4,5})"
+             << "\n";
+        cout << "Solution path: "
+             << "\n";
+        PrintVectorOfVectors(solution);
+        cout << "Your path: "
+             << "\n";
+        PrintVectorOfVectors(output);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSmoothPath()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SmoothPath Function Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto path = SearchPath(board, init, goal);
+    auto output = SmoothPath(board, path);
+
+    if (!IsDrivable(board, output, init, goal) || output.size() >= path.size() ||
+        PathLength(output) > PathLength(path))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "Input path: "
+             << "\n";
+        PrintVectorOfVectors(path);
+        cout << "Smoothed path: "
+             << "\n";
+        PrintVectorOfVectors(output);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestThetaStarSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ThetaStarSearch Function Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto output = ThetaStarSearch(board, init, goal);
+    vector<vector<State>> open(5, vector<State>(5, State::kEmpty));
+    int open_goal[2]{4, 3};
+    auto straight = ThetaStarSearch(open, init, open_goal);
+
+    if (!IsDrivable(board, output, init, goal) || PathLength(output) >= PathLength(SearchPath(board, init, goal)))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "ThetaStarSearch(board, {0,0}, {4,5})"
+             << "\n";
+        PrintVectorOfVectors(output);
+        cout << "\n";
+    }
+    else if (straight != vector<vector<int>>{{0, 0}, {4, 3}})
+    {
+        cout << "failed"
+             << "\n";
+        cout << "On an empty board the path should be one straight leg, got: "
+             << "\n";
+        PrintVectorOfVectors(straight);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
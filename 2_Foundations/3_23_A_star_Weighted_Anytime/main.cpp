@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "weighted_astar.h"
+
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+using namespace weighted_astar;
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Build a square board with randomly placed obstacles, keeping the corners free.
+ */
+vector<vector<State>> RandomBoard(int side, double density, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < density)
+                cell = State::kObstacle;
+    grid[0][0] = State::kEmpty;
+    grid[side - 1][side - 1] = State::kEmpty;
+    return grid;
+}
+
+/**
+ * Run the anytime search against a 2 ms deadline on a large board and print
+ * every solution as it is published.
+ */
+void DemoAnytimeSearch()
+{
+    cout << "==========================================================\n";
+    cout << "ARA* with a 2 ms deadline\n";
+    int side = 300;
+    auto board = RandomBoard(side, 0.2, 3);
+    int init[2]{0, 0};
+    int goal[2]{side - 1, side - 1};
+    Clock::time_point start = Clock::now();
+    auto on_solution = [start](const AnytimeSolution &solution) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        cout << "t = " << us << " us cost = " << solution.cost << " bound = " << solution.bound << "\n";
+    };
+    auto best = AnytimeSearch(board, init, goal, 3.0, 0.5, std::chrono::milliseconds(2), on_solution);
+    if (best.path.empty())
+        cout << "No solution within the deadline\n";
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto solution = Search(board, init, goal, 2.0);
+    PrintBoard(solution);
+    // Tests
+    TestWeightedSearch();
+    TestSearchDeadline();
+    TestAnytimeSearch();
+    DemoAnytimeSearch();
+}
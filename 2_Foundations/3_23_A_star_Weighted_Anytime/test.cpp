@@ -0,0 +1,178 @@
+void PrintVectorOfVectors(vector<vector<State>> v)
+{
+    for (auto row : v)
+    {
+        cout << "{ ";
+        for (auto col : row)
+        {
+            cout << CellString(col) << " ";
+        }
+        cout << "}"
+             << "\n";
+    }
+}
+
+/**
+ * Reference shortest path length by breadth-first search, -1 if unreachable.
+ */
+int OptimalCost(const vector<vector<State>> &grid, int init[2], int goal[2])
+{
+    int cols = grid[0].size();
+    vector<int> dist(grid.size() * cols, -1);
+    vector<int> queue{init[0] * cols + init[1]};
+    dist[queue[0]] = 0;
+    for (int head = 0; head < queue.size(); head++)
+    {
+        int cell = queue[head];
+        for (auto d : delta)
+        {
+            int x2 = cell / cols + d[0];
+            int y2 = cell % cols + d[1];
+            if (CheckValidCell(x2, y2, grid) && dist[x2 * cols + y2] < 0)
+            {
+                dist[x2 * cols + y2] = dist[cell] + 1;
+                queue.push_back(x2 * cols + y2);
+            }
+        }
+    }
+    return dist[goal[0] * cols + goal[1]];
+}
+
+// Number of moves on a board returned by Search
+int SolutionCost(const vector<vector<State>> &board)
+{
+    int cells = 0;
+    for (const auto &row : board)
+        for (auto cell : row)
+            cells += (cell == State::kPath || cell == State::kStart || cell == State::kFinish);
+    return cells - 1;
+}
+
+void TestWeightedSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Weighted Search Function Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    auto optimal = Search(board, init, goal);
+    std::cout.clear(); // Enable cout
+
+    auto big = RandomBoard(200, 0.3, 11);
+    int big_goal[2]{199, 199};
+    int reference = OptimalCost(big, init, big_goal);
+    auto weighted = Search(big, init, big_goal, 3.0);
+
+    if (SolutionCost(optimal) != OptimalCost(board, init, goal))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "Search(board, {0,0}, {4,5}) with weight 1 is not optimal: "
+             << "\n";
+        PrintVectorOfVectors(optimal);
+        cout << "\n";
+    }
+    else if (reference > 0 && (weighted.empty() || SolutionCost(weighted) > 3 * reference))
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Weight 3 returned cost " << SolutionCost(weighted) << ", bound is 3 x " << reference << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchDeadline()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Search Deadline Test: ";
+    auto big = RandomBoard(1000, 0.3, 5);
+    int init[2]{0, 0};
+    int goal[2]{999, 999};
+
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    auto output = Search(big, init, goal, 1.0, std::chrono::microseconds(0));
+    std::cout.clear(); // Enable cout
+
+    if (!output.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "A search with no time budget should time out."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestAnytimeSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "AnytimeSearch Function Test: ";
+    auto big = RandomBoard(200, 0.3, 11);
+    int init[2]{0, 0};
+    int goal[2]{199, 199};
+    int reference = OptimalCost(big, init, goal);
+
+    vector<AnytimeSolution> published;
+    auto best = AnytimeSearch(big, init, goal, 3.0, 0.5, std::chrono::seconds(10),
+                              [&published](const AnytimeSolution &solution) { published.push_back(solution); });
+
+    bool monotone = true;
+    for (int i = 1; i < published.size(); i++)
+    {
+        if (published[i].cost > published[i - 1].cost || published[i].bound > published[i - 1].bound)
+            monotone = false;
+    }
+    bool within_bound = true;
+    for (const auto &solution : published)
+    {
+        if (solution.cost > solution.bound * reference + 1e-6 || solution.path.size() != solution.cost + 1)
+            within_bound = false;
+    }
+
+    if (published.empty() || best.cost != reference || best.bound != 1.0)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Final cost " << best.cost << " bound " << best.bound << ", optimal cost is " << reference << "\n";
+        cout << "\n";
+    }
+    else if (!monotone || !within_bound)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Published solutions must improve monotonically and respect their bounds:"
+             << "\n";
+        for (const auto &solution : published)
+            cout << "cost = " << solution.cost << " bound = " << solution.bound << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
@@ -0,0 +1,344 @@
+#ifndef WEIGHTED_ASTAR_H
+#define WEIGHTED_ASTAR_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/**
+ * Weighted A* and anytime repairing A* (ARA*) on a 4-connected board. The
+ * engine has its own namespace so the differential tests in
+ * ../3_26_A_star_Differential_Testing can build it next to the others.
+ */
+namespace weighted_astar
+{
+using std::abs;
+using std::cout;
+using std::vector;
+
+using Clock = std::chrono::steady_clock;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+const int kNoCost = std::numeric_limits<int>::max();
+
+// Calculate the manhattan distance
+inline int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * Check that a cell is valid: on the grid and not an obstacle.
+ */
+inline bool CheckValidCell(int x, int y, const vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] != State::kObstacle;
+    return false;
+}
+
+/**
+ * Open list entry. f = g + weight * h, ties go to the deeper node.
+ */
+struct OpenEntry
+{
+    double f;
+    int g;
+    int cell;
+    bool operator<(const OpenEntry &other) const
+    {
+        return f > other.f || (f == other.f && g < other.g);
+    }
+};
+
+/**
+ * Per-cell search state kept alive between the iterations of an anytime
+ * search. The closed set is cleared in O(1) by bumping `stamp`.
+ */
+struct SearchScratch
+{
+    int rows;
+    int cols;
+    int goal;
+    vector<int> g;
+    vector<int> parent;
+    vector<int> closed;     // closed in the iteration whose stamp it holds
+    vector<char> in_open;
+    vector<char> in_incons;
+    vector<int> incons;     // cells improved after they were closed
+    vector<OpenEntry> open; // binary heap, see std::push_heap
+    int stamp;
+};
+
+inline SearchScratch MakeScratch(const vector<vector<State>> &grid, int init[2], int goal[2])
+{
+    int rows = grid.size();
+    int cols = grid[0].size();
+    int n = rows * cols;
+    SearchScratch s{rows, cols, goal[0] * cols + goal[1], vector<int>(n, kNoCost), vector<int>(n, -1),
+                    vector<int>(n, 0), vector<char>(n, 0), vector<char>(n, 0), {}, {}, 1};
+    int start = init[0] * cols + init[1];
+    s.g[start] = 0;
+    s.parent[start] = start;
+    return s;
+}
+
+inline int CellHeuristic(const SearchScratch &s, int cell)
+{
+    return Heuristic(cell / s.cols, cell % s.cols, s.goal / s.cols, s.goal % s.cols);
+}
+
+inline void AddToOpen(SearchScratch &s, int cell, double weight)
+{
+    s.open.push_back(OpenEntry{s.g[cell] + weight * CellHeuristic(s, cell), s.g[cell], cell});
+    std::push_heap(s.open.begin(), s.open.end());
+    s.in_open[cell] = 1;
+}
+
+/**
+ * Expand current cell's neighbors. Improved neighbors that are already closed
+ * in this iteration go to the inconsistent list instead of the open list.
+ */
+inline void ExpandNeighbors(int cell, double weight, SearchScratch &s, const vector<vector<State>> &grid)
+{
+    int x = cell / s.cols;
+    int y = cell % s.cols;
+    int g2 = s.g[cell] + 1;
+    for (int i = 0; i < 4; i++)
+    {
+        int x2 = x + delta[i][0];
+        int y2 = y + delta[i][1];
+        if (!CheckValidCell(x2, y2, grid))
+            continue;
+        int next = x2 * s.cols + y2;
+        if (g2 >= s.g[next])
+            continue;
+        s.g[next] = g2;
+        s.parent[next] = cell;
+        if (s.closed[next] != s.stamp)
+        {
+            AddToOpen(s, next, weight);
+        }
+        else if (!s.in_incons[next])
+        {
+            s.in_incons[next] = 1;
+            s.incons.push_back(next);
+        }
+    }
+}
+
+/**
+ * Expand nodes in order of g + weight * h until the goal cannot be improved
+ * by anything left on the open list. Returns false if the deadline passed.
+ */
+inline bool ImprovePath(SearchScratch &s, double weight, const vector<vector<State>> &grid,
+                        Clock::time_point deadline)
+{
+    int expansions = 0;
+    while (!s.open.empty())
+    {
+        // Checking the clock is not free, so only look every 256 expansions.
+        if ((expansions++ & 255) == 0 && Clock::now() >= deadline)
+            return false;
+
+        OpenEntry top = s.open.front();
+        if (s.g[s.goal] <= top.f)
+            return true;
+        std::pop_heap(s.open.begin(), s.open.end());
+        s.open.pop_back();
+
+        // Skip stale duplicates left behind when a cell's g improved.
+        if (!s.in_open[top.cell] || top.g != s.g[top.cell])
+            continue;
+        s.in_open[top.cell] = 0;
+        s.closed[top.cell] = s.stamp;
+        ExpandNeighbors(top.cell, weight, s, grid);
+    }
+    return true;
+}
+
+/**
+ * Follow the parent links from the goal back to the start.
+ */
+inline vector<vector<int>> TracePath(const SearchScratch &s)
+{
+    vector<vector<int>> path;
+    int cell = s.goal;
+    while (true)
+    {
+        path.push_back(vector<int>{cell / s.cols, cell % s.cols});
+        if (s.parent[cell] == cell)
+            break;
+        cell = s.parent[cell];
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * Suboptimality bound of a solution: its cost over the smallest unweighted f
+ * among the cells that could still improve it, capped at weight.
+ */
+inline double SuboptimalityBound(const SearchScratch &s, int cost, double weight)
+{
+    int lower = kNoCost;
+    for (const auto &entry : s.open)
+    {
+        if (s.in_open[entry.cell] && entry.g == s.g[entry.cell])
+            lower = std::min(lower, entry.g + CellHeuristic(s, entry.cell));
+    }
+    for (int cell : s.incons)
+        lower = std::min(lower, s.g[cell] + CellHeuristic(s, cell));
+    if (lower == kNoCost || lower >= cost)
+        return 1.0;
+    return std::min(weight, static_cast<double>(cost) / lower);
+}
+
+/**
+ * A published solution: the path, its cost, and a guarantee that the cost
+ * is at most `bound` times the optimal cost.
+ */
+struct AnytimeSolution
+{
+    vector<vector<int>> path;
+    int cost;
+    double bound;
+};
+
+/**
+ * Weighted A* from init to goal. Fills `path` with {x, y} cells, leaving it
+ * empty when the goal is unreachable, and returns the cost of the path, or
+ * kNoCost. Returns -1 if `deadline` passed before the search finished.
+ */
+inline int WeightedSearch(const vector<vector<State>> &grid, int init[2], int goal[2], double weight,
+                          Clock::time_point deadline, vector<vector<int>> &path)
+{
+    path.clear();
+    if (!CheckValidCell(init[0], init[1], grid) || !CheckValidCell(goal[0], goal[1], grid))
+        return kNoCost;
+    SearchScratch s = MakeScratch(grid, init, goal);
+    AddToOpen(s, init[0] * s.cols + init[1], weight);
+    if (!ImprovePath(s, weight, grid, deadline))
+        return -1;
+    if (s.g[s.goal] == kNoCost)
+        return kNoCost;
+    path = TracePath(s);
+    return path.size() - 1;
+}
+
+/**
+ * Weighted A* search. A weight above 1 inflates the heuristic, which expands
+ * fewer nodes and returns a path at most `weight` times longer than optimal.
+ * Gives up with "Search timed out!" once `budget` has elapsed.
+ */
+inline vector<vector<State>> Search(vector<vector<State>> grid, int init[2], int goal[2], double weight = 1.0,
+                                    Clock::duration budget = Clock::duration::max())
+{
+    Clock::time_point deadline =
+        budget == Clock::duration::max() ? Clock::time_point::max() : Clock::now() + budget;
+    vector<vector<int>> path;
+    int cost = WeightedSearch(grid, init, goal, weight, deadline, path);
+    if (cost < 0)
+    {
+        cout << "Search timed out!"
+             << "\n";
+        return std::vector<vector<State>>{};
+    }
+    if (cost == kNoCost)
+    {
+        cout << "No path found!"
+             << "\n";
+        return std::vector<vector<State>>{};
+    }
+
+    for (const auto &p : path)
+        grid[p[0]][p[1]] = State::kPath;
+    grid[init[0]][init[1]] = State::kStart;
+    grid[goal[0]][goal[1]] = State::kFinish;
+    return grid;
+}
+
+/**
+ * Anytime repairing A* (ARA*). Starts with weighted A* at `initial_weight`
+ * and, while time remains, lowers the weight by `weight_step` and repairs the
+ * previous search instead of starting over. Every improved path is passed to
+ * `publish` together with its suboptimality bound. Returns the best solution
+ * found before the deadline; its path is empty if none was found in time.
+ */
+inline AnytimeSolution AnytimeSearch(const vector<vector<State>> &grid, int init[2], int goal[2],
+                                     double initial_weight, double weight_step, Clock::duration budget,
+                                     std::function<void(const AnytimeSolution &)> publish = nullptr)
+{
+    Clock::time_point deadline = Clock::now() + budget;
+    AnytimeSolution best{{}, kNoCost, INFINITY};
+    if (!CheckValidCell(init[0], init[1], grid) || !CheckValidCell(goal[0], goal[1], grid))
+        return best;
+    SearchScratch s = MakeScratch(grid, init, goal);
+
+    double weight = initial_weight;
+    AddToOpen(s, init[0] * s.cols + init[1], weight);
+    while (true)
+    {
+        if (!ImprovePath(s, weight, grid, deadline) || s.g[s.goal] == kNoCost)
+            return best;
+
+        // Parents may have improved since the goal was reached, so the traced
+        // path can be shorter than g(goal); publish what will actually be driven.
+        auto path = TracePath(s);
+        int cost = path.size() - 1;
+        double bound = SuboptimalityBound(s, cost, weight);
+        if (cost < best.cost || bound < best.bound)
+        {
+            best = AnytimeSolution{path, cost, bound};
+            if (publish)
+                publish(best);
+        }
+        if (bound <= 1.0 || Clock::now() >= deadline)
+            return best;
+
+        // Lower the weight, move the inconsistent cells back to open and
+        // re-key the whole open list; the closed set is emptied by the stamp.
+        weight = std::max(1.0, weight - weight_step);
+        for (int cell : s.incons)
+        {
+            s.in_incons[cell] = 0;
+            s.in_open[cell] = 1;
+        }
+        vector<OpenEntry> rekeyed;
+        rekeyed.reserve(s.open.size() + s.incons.size());
+        for (const auto &entry : s.open)
+        {
+            if (s.in_open[entry.cell] && entry.g == s.g[entry.cell])
+                rekeyed.push_back(OpenEntry{entry.g + weight * CellHeuristic(s, entry.cell), entry.g, entry.cell});
+        }
+        for (int cell : s.incons)
+            rekeyed.push_back(OpenEntry{s.g[cell] + weight * CellHeuristic(s, cell), s.g[cell], cell});
+        s.incons.clear();
+        s.open.swap(rekeyed);
+        std::make_heap(s.open.begin(), s.open.end());
+        s.stamp++;
+    }
+}
+
+} // namespace weighted_astar
+
+#endif // WEIGHTED_ASTAR_H
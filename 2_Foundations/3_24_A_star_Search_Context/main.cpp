@@ -0,0 +1,273 @@
+#include <algorithm> // for sort
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "search_context.h"
+
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::sort;
+using std::string;
+using std::vector;
+using namespace search_context;
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+/**
+ * Compare the F values of two cells.
+ */
+bool Compare(const vector<int> a, const vector<int> b)
+{
+    int f1 = a[2] + a[3]; // f1 = g1 + h1
+    int f2 = b[2] + b[3]; // f2 = g2 + h2
+    return f1 > f2;
+}
+
+/**
+ * Sort the two-dimensional vector of ints in descending order.
+ */
+void CellSort(vector<vector<int>> *v)
+{
+    sort(v->begin(), v->end(), Compare);
+}
+
+/**
+ * Check that a cell is valid: on the grid, not an obstacle, and clear.
+ */
+bool CheckValidCell(int x, int y, vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] == State::kEmpty;
+    return false;
+}
+
+/**
+ * Add a node to the open list and mark it as open.
+ */
+void AddToOpen(int x, int y, int g, int h, vector<vector<int>> &openlist, vector<vector<State>> &grid)
+{
+    // Add node to open vector, and mark grid cell as closed.
+    openlist.push_back(vector<int>{x, y, g, h});
+    grid[x][y] = State::kClosed;
+}
+
+/**
+ * Expand current nodes's neighbors and add them to the open list.
+ */
+void ExpandNeighbors(const vector<int> &current, int goal[2], vector<vector<int>> &openlist, vector<vector<State>> &grid)
+{
+    // Get current node's data.
+    int x = current[0];
+    int y = current[1];
+    int g = current[2];
+
+    // Loop through current node's potential neighbors.
+    for (int i = 0; i < 4; i++)
+    {
+        int x2 = x + delta[i][0];
+        int y2 = y + delta[i][1];
+
+        // Check that the potential neighbor's x2 and y2 values are on the grid and not closed.
+        if (CheckValidCell(x2, y2, grid))
+        {
+            // Increment g value and add neighbor to open list.
+            int g2 = g + 1;
+            int h2 = Heuristic(x2, y2, goal[0], goal[1]);
+            AddToOpen(x2, y2, g2, h2, openlist, grid);
+        }
+    }
+}
+
+/**
+ * Implementation of A* search algorithm
+ */
+vector<vector<State>> Search(vector<vector<State>> grid, int init[2], int goal[2])
+{
+    // Create the vector of open nodes.
+    vector<vector<int>> open{};
+
+    // Initialize the starting node.
+    int x = init[0];
+    int y = init[1];
+    int g = 0;
+    int h = Heuristic(x, y, goal[0], goal[1]);
+    AddToOpen(x, y, g, h, open, grid);
+
+    while (open.size() > 0)
+    {
+        // Get the next node
+        CellSort(&open);
+        auto current = open.back();
+        open.pop_back();
+        x = current[0];
+        y = current[1];
+        grid[x][y] = State::kPath;
+
+        // Check if we're done.
+        if (x == goal[0] && y == goal[1])
+        {
+            grid[init[0]][init[1]] = State::kStart;
+            grid[goal[0]][goal[1]] = State::kFinish;
+            return grid;
+        }
+
+        // If we're not done, expand search to current node's neighbors.
+        ExpandNeighbors(current, goal, open, grid);
+    }
+
+    // We've run out of new nodes to explore and haven't found a path.
+    cout << "No path found!"
+         << "\n";
+    return std::vector<vector<State>>{};
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Mark a path found by a SearchContext on a copy of the board. An empty path
+ * (no route found) leaves the board unchanged.
+ */
+vector<vector<State>> DrawPath(vector<vector<State>> grid, PathView path, int cols)
+{
+    if (path.empty())
+        return grid;
+    for (int cell : path)
+        grid[cell / cols][cell % cols] = State::kPath;
+    grid[*path.begin() / cols][*path.begin() % cols] = State::kStart;
+    grid[*(path.end() - 1) / cols][*(path.end() - 1) % cols] = State::kFinish;
+    return grid;
+}
+
+/**
+ * Compare repeated queries through Search and through one SearchContext.
+ */
+void BenchmarkSearchContext()
+{
+    cout << "==========================================================\n";
+    cout << "Repeated queries on a 64x64 board\n";
+    int side = 64;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (auto &row : board)
+        for (auto &cell : row)
+            if (coin(rng) < 0.2)
+                cell = State::kObstacle;
+
+    std::uniform_int_distribution<int> pos(0, side - 1);
+    vector<int> queries;
+    while (queries.size() < 4 * 100)
+    {
+        int x0 = pos(rng), y0 = pos(rng), x1 = pos(rng), y1 = pos(rng);
+        if (board[x0][y0] == State::kEmpty && board[x1][y1] == State::kEmpty)
+            queries.insert(queries.end(), {x0, y0, x1, y1});
+    }
+
+    SearchContext context(board);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    for (int i = 0; i < queries.size(); i += 4)
+        Search(board, &queries[i], &queries[i + 2]);
+    std::cout.clear(); // Enable cout
+    auto t2 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queries.size(); i += 4)
+        context.Search(&queries[i], &queries[i + 2]);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    auto us = [](std::chrono::high_resolution_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    cout << "Search: " << us(t2 - t1) / 100.0 << " microseconds/query\n";
+    cout << "SearchContext: " << us(t3 - t2) / 100.0 << " microseconds/query\n";
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    SearchContext context(board);
+    auto path = context.Search(init, goal);
+    PrintBoard(DrawPath(board, path, context.Cols()));
+    // Tests
+    TestSearchContext();
+    TestSearchContextReuse();
+    TestSearchContextAllocations();
+    BenchmarkSearchContext();
+}
@@ -0,0 +1,272 @@
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * A* with a reusable, arena-backed SearchContext. The engine has its own
+ * namespace so the differential tests in ../3_26_A_star_Differential_Testing
+ * can build it next to the others.
+ */
+namespace search_context
+{
+using std::abs;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+// Calculate the manhattan distance
+inline int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * A bump allocator over one heap block. Memory is handed out once, when a
+ * SearchContext is built, and released together with the arena.
+ */
+class Arena
+{
+  public:
+    explicit Arena(size_t bytes) : block(new unsigned char[bytes]), capacity(bytes) {}
+
+    template <typename T>
+    T *Allocate(size_t count)
+    {
+        size_t start = (used + alignof(T) - 1) / alignof(T) * alignof(T);
+        if (start + count * sizeof(T) > capacity)
+            throw std::bad_alloc();
+        used = start + count * sizeof(T);
+        return reinterpret_cast<T *>(block.get() + start);
+    }
+
+  private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity;
+    size_t used = 0;
+};
+
+/**
+ * Read-only view of the path found by the last SearchContext query, as flat
+ * cell indices x * cols + y from init to goal.
+ */
+struct PathView
+{
+    const int *cells;
+    int size;
+
+    const int *begin() const { return cells; }
+    const int *end() const { return cells + size; }
+    bool empty() const { return size == 0; }
+};
+
+/**
+ * Reusable A* state for one board. All per-cell buffers (g-scores, parents,
+ * open/closed flags, the open heap and the output path) are carved out of a
+ * single arena sized to the map, so queries never touch the heap. Instead of
+ * clearing the buffers, every query bumps a generation number: a cell whose
+ * stamp is older than the current generation is treated as unvisited.
+ */
+class SearchContext
+{
+  public:
+    explicit SearchContext(const vector<vector<State>> &grid)
+        : rows(grid.size()), cols(grid[0].size()), n(rows * cols),
+          arena(n * (sizeof(uint8_t) + 5 * sizeof(int) + sizeof(uint32_t)) + 64)
+    {
+        blocked = arena.Allocate<uint8_t>(n);
+        g = arena.Allocate<int>(n);
+        parent = arena.Allocate<int>(n);
+        heap = arena.Allocate<int>(n);
+        heap_pos = arena.Allocate<int>(n);
+        path = arena.Allocate<int>(n);
+        stamp = arena.Allocate<uint32_t>(n);
+        for (int x = 0; x < rows; x++)
+            for (int y = 0; y < cols; y++)
+                blocked[x * cols + y] = grid[x][y] == State::kObstacle;
+        for (int i = 0; i < n; i++)
+            stamp[i] = 0;
+    }
+
+    void SetObstacle(int x, int y, bool obstacle) { blocked[x * cols + y] = obstacle; }
+
+    /**
+     * Run A* from init to goal. The returned view stays valid until the next query.
+     */
+    PathView Search(int init[2], int goal[2])
+    {
+        NextGeneration();
+        goal_x = goal[0];
+        goal_y = goal[1];
+        heap_size = 0;
+        path_size = 0;
+
+        int start = init[0] * cols + init[1];
+        int target = goal[0] * cols + goal[1];
+        if (blocked[start] || blocked[target])
+            return PathView{path, 0};
+        g[start] = 0;
+        parent[start] = start;
+        Push(start);
+
+        while (heap_size > 0)
+        {
+            int cell = Pop();
+            stamp[cell] = closed_stamp;
+            if (cell == target)
+            {
+                TracePath(target);
+                break;
+            }
+
+            int x = cell / cols;
+            int y = cell % cols;
+            for (int i = 0; i < 4; i++)
+            {
+                int x2 = x + delta[i][0];
+                int y2 = y + delta[i][1];
+                if (x2 < 0 || x2 >= rows || y2 < 0 || y2 >= cols)
+                    continue;
+                int next = x2 * cols + y2;
+                if (blocked[next] || stamp[next] == closed_stamp)
+                    continue;
+                if (stamp[next] != open_stamp)
+                {
+                    g[next] = g[cell] + 1;
+                    parent[next] = cell;
+                    Push(next);
+                }
+                else if (g[cell] + 1 < g[next])
+                {
+                    g[next] = g[cell] + 1;
+                    parent[next] = cell;
+                    SiftUp(heap_pos[next]);
+                }
+            }
+        }
+        return PathView{path, path_size};
+    }
+
+    int Cols() const { return cols; }
+
+  private:
+    // Each query owns two stamp values: one for open cells, one for closed cells.
+    void NextGeneration()
+    {
+        if (closed_stamp >= UINT32_MAX - 2)
+        {
+            for (int i = 0; i < n; i++)
+                stamp[i] = 0;
+            closed_stamp = 0;
+        }
+        open_stamp = closed_stamp + 1;
+        closed_stamp += 2;
+    }
+
+    int F(int cell) const { return g[cell] + Heuristic(cell / cols, cell % cols, goal_x, goal_y); }
+
+    // Order by f, and prefer the deeper cell on ties.
+    bool Before(int a, int b) const { return F(a) < F(b) || (F(a) == F(b) && g[a] > g[b]); }
+
+    void Place(int i, int cell)
+    {
+        heap[i] = cell;
+        heap_pos[cell] = i;
+    }
+
+    void SiftUp(int i)
+    {
+        int cell = heap[i];
+        while (i > 0 && Before(cell, heap[(i - 1) / 2]))
+        {
+            Place(i, heap[(i - 1) / 2]);
+            i = (i - 1) / 2;
+        }
+        Place(i, cell);
+    }
+
+    void SiftDown(int i)
+    {
+        int cell = heap[i];
+        while (true)
+        {
+            int child = 2 * i + 1;
+            if (child >= heap_size)
+                break;
+            if (child + 1 < heap_size && Before(heap[child + 1], heap[child]))
+                child++;
+            if (!Before(heap[child], cell))
+                break;
+            Place(i, heap[child]);
+            i = child;
+        }
+        Place(i, cell);
+    }
+
+    void Push(int cell)
+    {
+        stamp[cell] = open_stamp;
+        Place(heap_size, cell);
+        SiftUp(heap_size++);
+    }
+
+    int Pop()
+    {
+        int top = heap[0];
+        if (--heap_size > 0)
+        {
+            Place(0, heap[heap_size]);
+            SiftDown(0);
+        }
+        return top;
+    }
+
+    void TracePath(int target)
+    {
+        for (int cell = target;; cell = parent[cell])
+        {
+            path[path_size++] = cell;
+            if (parent[cell] == cell)
+                break;
+        }
+        std::reverse(path, path + path_size);
+    }
+
+    int rows;
+    int cols;
+    int n;
+    Arena arena;
+    uint8_t *blocked;
+    int *g;
+    int *parent;
+    int *heap;
+    int *heap_pos;
+    int *path;
+    uint32_t *stamp;
+    uint32_t open_stamp = 0;
+    uint32_t closed_stamp = 0;
+    int heap_size = 0;
+    int path_size = 0;
+    int goal_x = 0;
+    int goal_y = 0;
+};
+
+} // namespace search_context
+
+#endif // SEARCH_CONTEXT_H
@@ -0,0 +1,187 @@
+// Count calls to malloc while `count_allocations` is set. Defining malloc in
+// the program overrides the C library's for every caller, operator new
+// included; glibc still exports the real allocator as __libc_malloc.
+long allocation_count = 0;
+bool count_allocations = false;
+
+#ifdef __GLIBC__
+extern "C" void *__libc_malloc(size_t size);
+
+extern "C" void *malloc(size_t size) noexcept
+{
+    if (count_allocations)
+        allocation_count++;
+    return __libc_malloc(size);
+}
+#endif
+
+/**
+ * Reference shortest path length by breadth-first search, -1 if unreachable.
+ */
+int OptimalCost(const vector<vector<State>> &grid, int init[2], int goal[2])
+{
+    int cols = grid[0].size();
+    vector<int> dist(grid.size() * cols, -1);
+    vector<int> queue{init[0] * cols + init[1]};
+    dist[queue[0]] = 0;
+    for (int head = 0; head < queue.size(); head++)
+    {
+        int cell = queue[head];
+        for (auto d : delta)
+        {
+            int x2 = cell / cols + d[0];
+            int y2 = cell % cols + d[1];
+            if (x2 >= 0 && x2 < grid.size() && y2 >= 0 && y2 < cols && grid[x2][y2] != State::kObstacle &&
+                dist[x2 * cols + y2] < 0)
+            {
+                dist[x2 * cols + y2] = dist[cell] + 1;
+                queue.push_back(x2 * cols + y2);
+            }
+        }
+    }
+    return dist[goal[0] * cols + goal[1]];
+}
+
+vector<vector<State>> RandomBoard(int side, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (auto &row : board)
+        for (auto &cell : row)
+            if (coin(rng) < 0.25)
+                cell = State::kObstacle;
+    return board;
+}
+
+void TestSearchContext()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SearchContext Function Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    SearchContext context(board);
+    auto output = DrawPath(board, context.Search(init, goal), context.Cols());
+
+    vector<vector<State>> solution{{State::kStart, State::kObstacle, State::kEmpty, State::kEmpty, State::kEmpty, State::kEmpty},
+                                   {State::kPath, State::kObstacle, State::kEmpty, State::kEmpty, State::kEmpty, State::kEmpty},
+                                   {State::kPath, State::kObstacle, State::kEmpty, State::kEmpty, State::kEmpty, State::kEmpty},
+                                   {State::kPath, State::kObstacle, State::kEmpty, State::kPath, State::kPath, State::kPath},
+                                   {State::kPath, State::kPath, State::kPath, State::kPath, State::kObstacle, State::kFinish}};
+
+    if (output != solution)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "SearchContext.Search({0,0}, {4,5})"
+             << "\n";
+        cout << "Solution board: "
+             << "\n";
+        PrintBoard(solution);
+        cout << "Your board: "
+             << "\n";
+        PrintBoard(output);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchContextReuse()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SearchContext Reuse Test: ";
+    auto board = RandomBoard(40, 3);
+    SearchContext context(board);
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<int> pos(0, 39);
+
+    // Later queries must not see stale state from earlier ones.
+    int mismatches = 0;
+    for (int q = 0; q < 500; q++)
+    {
+        int init[2]{pos(rng), pos(rng)};
+        int goal[2]{pos(rng), pos(rng)};
+        if (board[init[0]][init[1]] == State::kObstacle || board[goal[0]][goal[1]] == State::kObstacle)
+            continue;
+        auto path = context.Search(init, goal);
+        if (path.size - 1 != OptimalCost(board, init, goal))
+            mismatches++;
+    }
+
+    if (mismatches > 0)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << mismatches << " queries returned a path that is not the shortest."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchContextAllocations()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "SearchContext Allocation Test: ";
+    auto board = RandomBoard(64, 5);
+    board[0][0] = State::kEmpty;
+    board[63][63] = State::kEmpty;
+    int init[2]{0, 0};
+    int goal[2]{63, 63};
+    SearchContext context(board);
+    context.Search(init, goal);
+
+    allocation_count = 0;
+    count_allocations = true;
+    for (int q = 0; q < 1000; q++)
+        context.Search(init, goal);
+    count_allocations = false;
+    long context_allocations = allocation_count;
+
+    allocation_count = 0;
+    count_allocations = true;
+    std::cout.setstate(std::ios_base::failbit); // Disable cout
+    Search(board, init, goal);
+    std::cout.clear(); // Enable cout
+    count_allocations = false;
+    long search_allocations = allocation_count;
+
+#ifndef __GLIBC__
+    cout << "skipped (malloc is only counted with glibc)"
+         << "\n";
+#else
+    if (context_allocations != 0 || search_allocations == 0)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "1000 SearchContext queries allocated " << context_allocations << " times, one Search call "
+             << search_allocations << " times."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+#endif
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
@@ -0,0 +1,248 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Flow fields towards one goal, serial and level-synchronous parallel. The
+ * engine has its own namespace so the differential tests in
+ * ../3_26_A_star_Differential_Testing can build it next to the others.
+ */
+namespace flow_field
+{
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+/**
+ * Distance to one goal from every cell, plus the direction (an index into
+ * `delta`) that leads one step closer. Unreachable cells have distance -1,
+ * and cells without a next step (the goal, unreachable cells) direction -1.
+ */
+struct FlowField
+{
+    int rows;
+    int cols;
+    vector<int> distance;
+    vector<int8_t> direction;
+};
+
+/**
+ * Point every reachable cell at its neighbor with the smallest distance.
+ * Only rows [row_begin, row_end) are written, so bands can run in parallel.
+ */
+inline void ComputeDirections(FlowField &field, int row_begin, int row_end)
+{
+    for (int x = row_begin; x < row_end; x++)
+    {
+        for (int y = 0; y < field.cols; y++)
+        {
+            int i = x * field.cols + y;
+            field.direction[i] = -1;
+            if (field.distance[i] <= 0)
+                continue;
+            for (int d = 0; d < 4; d++)
+            {
+                int x2 = x + delta[d][0];
+                int y2 = y + delta[d][1];
+                if (x2 < 0 || x2 >= field.rows || y2 < 0 || y2 >= field.cols)
+                    continue;
+                if (field.distance[x2 * field.cols + y2] == field.distance[i] - 1)
+                {
+                    field.direction[i] = d;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Build the flow field towards `goal` with a breadth-first wavefront over the
+ * flat grid. Every move costs 1, so the FIFO queue already pops cells in
+ * distance order and plays the role of Dial's bucket queue.
+ */
+inline FlowField ComputeFlowField(const vector<vector<State>> &grid, int goal[2])
+{
+    int rows = grid.size();
+    int cols = grid[0].size();
+    FlowField field{rows, cols, vector<int>(rows * cols, -1), vector<int8_t>(rows * cols, -1)};
+    if (grid[goal[0]][goal[1]] == State::kObstacle)
+        return field;
+
+    vector<int> queue;
+    queue.reserve(rows * cols);
+    queue.push_back(goal[0] * cols + goal[1]);
+    field.distance[queue[0]] = 0;
+    for (int head = 0; head < queue.size(); head++)
+    {
+        int cell = queue[head];
+        int x = cell / cols;
+        int y = cell % cols;
+        for (auto d : delta)
+        {
+            int x2 = x + d[0];
+            int y2 = y + d[1];
+            if (x2 < 0 || x2 >= rows || y2 < 0 || y2 >= cols || grid[x2][y2] == State::kObstacle)
+                continue;
+            int next = x2 * cols + y2;
+            if (field.distance[next] < 0)
+            {
+                field.distance[next] = field.distance[cell] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    ComputeDirections(field, 0, rows);
+    return field;
+}
+
+/**
+ * Reusable barrier for a fixed number of threads.
+ */
+class Barrier
+{
+  public:
+    Barrier(int count) : count(count) {}
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        int my_generation = generation;
+        if (++waiting == count)
+        {
+            waiting = 0;
+            generation++;
+            cond.notify_all();
+            return;
+        }
+        cond.wait(lock, [&] { return generation != my_generation; });
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    int count;
+    int waiting = 0;
+    int generation = 0;
+};
+
+/**
+ * Level-synchronous variant of ComputeFlowField for large maps. Each level
+ * of the wavefront is split across `n_threads`; a cell is claimed with a
+ * compare-and-swap on its distance so exactly one thread queues it.
+ */
+inline FlowField ComputeFlowFieldParallel(const vector<vector<State>> &grid, int goal[2], int n_threads)
+{
+    int rows = grid.size();
+    int cols = grid[0].size();
+    int n = rows * cols;
+    FlowField field{rows, cols, vector<int>(n, -1), vector<int8_t>(n, -1)};
+    if (grid[goal[0]][goal[1]] == State::kObstacle)
+        return field;
+    n_threads = std::max(1, std::min(n_threads, rows));
+
+    vector<std::atomic<int>> distance(n);
+    for (auto &d : distance)
+        d.store(-1, std::memory_order_relaxed);
+    vector<int> frontier{goal[0] * cols + goal[1]};
+    distance[frontier[0]].store(0, std::memory_order_relaxed);
+    vector<vector<int>> next(n_threads);
+    int level = 0;
+    bool done = false;
+    Barrier barrier(n_threads);
+
+    auto worker = [&](int t) {
+        while (true)
+        {
+            barrier.Wait();
+            if (done)
+                return;
+            int begin = frontier.size() * t / n_threads;
+            int end = frontier.size() * (t + 1) / n_threads;
+            for (int f = begin; f < end; f++)
+            {
+                int cell = frontier[f];
+                int x = cell / cols;
+                int y = cell % cols;
+                for (auto d : delta)
+                {
+                    int x2 = x + d[0];
+                    int y2 = y + d[1];
+                    if (x2 < 0 || x2 >= rows || y2 < 0 || y2 >= cols || grid[x2][y2] == State::kObstacle)
+                        continue;
+                    int expected = -1;
+                    if (distance[x2 * cols + y2].compare_exchange_strong(expected, level + 1,
+                                                                         std::memory_order_relaxed))
+                        next[t].push_back(x2 * cols + y2);
+                }
+            }
+            barrier.Wait();
+            // Thread 0 gathers the next level while the others wait at the top.
+            if (t == 0)
+            {
+                frontier.clear();
+                for (auto &part : next)
+                {
+                    frontier.insert(frontier.end(), part.begin(), part.end());
+                    part.clear();
+                }
+                level++;
+                done = frontier.empty();
+            }
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int t = 1; t < n_threads; t++)
+        threads.emplace_back(worker, t);
+    worker(0);
+    for (auto &t : threads)
+        t.join();
+
+    for (int i = 0; i < n; i++)
+        field.distance[i] = distance[i].load(std::memory_order_relaxed);
+
+    threads.clear();
+    for (int t = 0; t < n_threads; t++)
+        threads.emplace_back(ComputeDirections, std::ref(field), rows * t / n_threads, rows * (t + 1) / n_threads);
+    for (auto &t : threads)
+        t.join();
+    return field;
+}
+
+/**
+ * O(1) lookup of an agent's next cell. Returns false at the goal or when
+ * the goal cannot be reached from (x, y).
+ */
+inline bool NextStep(const FlowField &field, int x, int y, int &next_x, int &next_y)
+{
+    int d = field.direction[x * field.cols + y];
+    if (d < 0)
+        return false;
+    next_x = x + delta[d][0];
+    next_y = y + delta[d][1];
+    return true;
+}
+
+} // namespace flow_field
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flow_field.h"
+
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+using namespace flow_field;
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Print the direction field as arrows, with the goal as a flag.
+ */
+void PrintFlowField(const FlowField &field)
+{
+    const string arrows[4]{"⬆️   ", "⬅️   ", "⬇️   ", "➡️   "};
+    for (int x = 0; x < field.rows; x++)
+    {
+        for (int y = 0; y < field.cols; y++)
+        {
+            int i = x * field.cols + y;
+            if (field.distance[i] == 0)
+                cout << "🏁   ";
+            else if (field.direction[i] < 0)
+                cout << "⛰️   ";
+            else
+                cout << arrows[field.direction[i]];
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Build the field on a large map serially and with the wavefront threads,
+ * then walk a crowd of agents to the goal through NextStep.
+ */
+void BenchmarkFlowField()
+{
+    cout << "==========================================================\n";
+    cout << "Flow field on a 2000x2000 board\n";
+    int side = 2000;
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (auto &row : board)
+        for (auto &cell : row)
+            if (coin(rng) < 0.2)
+                cell = State::kObstacle;
+    int goal[2]{side / 2, side / 2};
+    board[goal[0]][goal[1]] = State::kEmpty;
+
+    auto ms = [](std::chrono::high_resolution_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto field = ComputeFlowField(board, goal);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    cout << "Serial: " << ms(t2 - t1) << " ms\n";
+    int n_threads = std::max(2u, std::thread::hardware_concurrency());
+    t1 = std::chrono::high_resolution_clock::now();
+    ComputeFlowFieldParallel(board, goal, n_threads);
+    t2 = std::chrono::high_resolution_clock::now();
+    cout << "Wavefront, " << n_threads << " threads: " << ms(t2 - t1) << " ms\n";
+
+    // Every agent reads its next step from the same field.
+    std::uniform_int_distribution<int> pos(0, side - 1);
+    long steps = 0;
+    int arrived = 0;
+    t1 = std::chrono::high_resolution_clock::now();
+    for (int agent = 0; agent < 1000; agent++)
+    {
+        int x = pos(rng), y = pos(rng);
+        int nx, ny;
+        while (NextStep(field, x, y, nx, ny))
+        {
+            x = nx;
+            y = ny;
+            steps++;
+        }
+        arrived += (x == goal[0] && y == goal[1]);
+    }
+    t2 = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t2 - t1).count();
+    cout << "1000 agents, " << arrived << " arrived in " << steps << " steps, " << ns / steps << " ns/step\n";
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto field = ComputeFlowField(board, goal);
+    PrintFlowField(field);
+    // Tests
+    TestComputeFlowField();
+    TestNextStep();
+    TestComputeFlowFieldParallel();
+    BenchmarkFlowField();
+}
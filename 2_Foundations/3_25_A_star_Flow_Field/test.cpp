@@ -0,0 +1,137 @@
+void PrintVector(vector<int> v)
+{
+    cout << "{ ";
+    for (auto item : v)
+    {
+        cout << item << " ";
+    }
+    cout << "}"
+         << "\n";
+}
+
+vector<vector<State>> RandomBoard(int side, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (auto &row : board)
+        for (auto &cell : row)
+            if (coin(rng) < 0.3)
+                cell = State::kObstacle;
+    return board;
+}
+
+void TestComputeFlowField()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ComputeFlowField Function Test: ";
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto field = ComputeFlowField(board, goal);
+    vector<int> solution{11, -1, 7, 6, 5, 4,
+                         10, -1, 6, 5, 4, 3,
+                         9, -1, 5, 4, 3, 2,
+                         8, -1, 4, 3, 2, 1,
+                         7, 6, 5, 4, -1, 0};
+
+    if (field.distance != solution)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Distances to (4, 5): "
+             << "\n";
+        PrintVector(field.distance);
+        cout << "Solution: "
+             << "\n";
+        PrintVector(solution);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestNextStep()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "NextStep Function Test: ";
+    auto board = RandomBoard(50, 2);
+    int goal[2]{25, 25};
+    board[25][25] = State::kEmpty;
+    auto field = ComputeFlowField(board, goal);
+
+    // Following the arrows from any reachable cell takes exactly `distance` steps.
+    int wrong = 0;
+    for (int x = 0; x < 50; x++)
+    {
+        for (int y = 0; y < 50; y++)
+        {
+            int expected = field.distance[x * 50 + y];
+            int cx = x, cy = y, nx, ny, steps = 0;
+            while (NextStep(field, cx, cy, nx, ny))
+            {
+                if (board[nx][ny] == State::kObstacle)
+                    break;
+                cx = nx;
+                cy = ny;
+                steps++;
+            }
+            if (expected >= 0 && (steps != expected || cx != goal[0] || cy != goal[1]))
+                wrong++;
+            if (expected < 0 && steps != 0)
+                wrong++;
+        }
+    }
+
+    if (wrong > 0)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << wrong << " cells do not lead to the goal along a shortest path."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestComputeFlowFieldParallel()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ComputeFlowFieldParallel Function Test: ";
+    auto board = RandomBoard(120, 9);
+    int goal[2]{60, 60};
+    board[60][60] = State::kEmpty;
+    auto serial = ComputeFlowField(board, goal);
+    auto parallel = ComputeFlowFieldParallel(board, goal, 4);
+
+    if (parallel.distance != serial.distance || parallel.direction != serial.direction)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The wavefront threads disagree with the serial flow field."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
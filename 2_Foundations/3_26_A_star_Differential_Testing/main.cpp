@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../3_23_A_star_Weighted_Anytime/weighted_astar.h"
+#include "../3_24_A_star_Search_Context/search_context.h"
+#include "../3_25_A_star_Flow_Field/flow_field.h"
+#include "../3_27_A_star_Bucket_Queue/bucket_queue.h"
+
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+bool IsFree(int x, int y, const vector<vector<State>> &grid)
+{
+    return x >= 0 && x < grid.size() && y >= 0 && y < grid[0].size() && grid[x][y] != State::kObstacle;
+}
+
+/**
+ * A planner under test. It returns the cost of its path from init to goal,
+ * or -1 if it reports that no path exists, and fills `path` with {x, y} cells.
+ * Its cost may be at most `bound` times the optimal cost; 1 means it must be
+ * optimal, INFINITY that only reachability and the path itself are checked.
+ */
+struct Engine
+{
+    string name;
+    std::function<int(const vector<vector<State>> &, int *, int *, vector<vector<int>> &)> run;
+    double bound = 1.0;
+};
+
+/**
+ * Reference Dijkstra over the 4-connected board. Deliberately the plainest
+ * possible implementation, with no heuristic, so it can serve as the oracle.
+ */
+int ReferenceDijkstra(const vector<vector<State>> &grid, int init[2], int goal[2])
+{
+    if (!IsFree(init[0], init[1], grid) || !IsFree(goal[0], goal[1], grid))
+        return -1;
+    int cols = grid[0].size();
+    vector<int> dist(grid.size() * cols, INT32_MAX);
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry>> open;
+    dist[init[0] * cols + init[1]] = 0;
+    open.push(Entry{0, init[0] * cols + init[1]});
+    while (!open.empty())
+    {
+        auto [d, cell] = open.top();
+        open.pop();
+        if (d > dist[cell])
+            continue;
+        if (cell == goal[0] * cols + goal[1])
+            return d;
+        for (auto step : delta)
+        {
+            int x2 = cell / cols + step[0];
+            int y2 = cell % cols + step[1];
+            if (IsFree(x2, y2, grid) && d + 1 < dist[x2 * cols + y2])
+            {
+                dist[x2 * cols + y2] = d + 1;
+                open.push(Entry{d + 1, x2 * cols + y2});
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * Copy a board into the State type of one of the engines' namespaces.
+ */
+template <typename EngineState>
+vector<vector<EngineState>> ToBoard(const vector<vector<State>> &grid)
+{
+    vector<vector<EngineState>> board;
+    for (const auto &row : grid)
+    {
+        board.emplace_back();
+        for (auto cell : row)
+            board.back().push_back(cell == State::kObstacle ? EngineState::kObstacle : EngineState::kEmpty);
+    }
+    return board;
+}
+
+// Adapters from each engine's own API to the one the harness calls.
+
+int WeightedAStar(double weight, const vector<vector<State>> &grid, int init[2], int goal[2],
+                  vector<vector<int>> &path)
+{
+    auto board = ToBoard<weighted_astar::State>(grid);
+    auto no_deadline = weighted_astar::Clock::time_point::max();
+    int cost = weighted_astar::WeightedSearch(board, init, goal, weight, no_deadline, path);
+    return cost == weighted_astar::kNoCost ? -1 : cost;
+}
+
+int AnytimeAStar(const vector<vector<State>> &grid, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    // The boards are small enough that ARA* always reaches weight 1 in time.
+    auto board = ToBoard<weighted_astar::State>(grid);
+    auto best = weighted_astar::AnytimeSearch(board, init, goal, 3.0, 0.5, std::chrono::seconds(10));
+    path = best.path;
+    return path.empty() ? -1 : best.cost;
+}
+
+int ContextAStar(const vector<vector<State>> &grid, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    search_context::SearchContext context(ToBoard<search_context::State>(grid));
+    path.clear();
+    for (int cell : context.Search(init, goal))
+        path.push_back(vector<int>{cell / context.Cols(), cell % context.Cols()});
+    return static_cast<int>(path.size()) - 1;
+}
+
+/**
+ * Follow the flow field's directions from init, as an agent would.
+ */
+int FollowFlowField(const flow_field::FlowField &field, int init[2], vector<vector<int>> &path)
+{
+    path.clear();
+    int x = init[0];
+    int y = init[1];
+    if (field.distance[x * field.cols + y] < 0)
+        return -1;
+    path.push_back(vector<int>{x, y});
+    while (flow_field::NextStep(field, x, y, x, y))
+        path.push_back(vector<int>{x, y});
+    return field.distance[init[0] * field.cols + init[1]];
+}
+
+int FlowField(const vector<vector<State>> &grid, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    auto field = flow_field::ComputeFlowField(ToBoard<flow_field::State>(grid), goal);
+    return FollowFlowField(field, init, path);
+}
+
+int ParallelFlowField(const vector<vector<State>> &grid, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    auto field = flow_field::ComputeFlowFieldParallel(ToBoard<flow_field::State>(grid), goal, 4);
+    return FollowFlowField(field, init, path);
+}
+
+int OpenListAStar(bucket_queue::OpenListPolicy policy, const vector<vector<State>> &grid, int init[2], int goal[2],
+                  vector<vector<int>> &path)
+{
+    auto result = bucket_queue::FindPath(ToBoard<bucket_queue::State>(grid), init, goal, policy);
+    path = result.path;
+    return path.empty() ? -1 : static_cast<int>(result.cost);
+}
+
+/**
+ * Every real planner in the lessons, each behind its adapter.
+ */
+vector<Engine> AllEngines()
+{
+    using namespace std::placeholders;
+    using bucket_queue::OpenListPolicy;
+    return vector<Engine>{
+        {"Weighted A* (3_23), w = 1", std::bind(WeightedAStar, 1.0, _1, _2, _3, _4)},
+        {"Weighted A* (3_23), w = 1.5", std::bind(WeightedAStar, 1.5, _1, _2, _3, _4), 1.5},
+        {"ARA* (3_23)", AnytimeAStar},
+        {"SearchContext (3_24)", ContextAStar},
+        {"Flow field (3_25)", FlowField},
+        {"Parallel flow field (3_25)", ParallelFlowField},
+        {"Heap A* (3_27)", std::bind(OpenListAStar, OpenListPolicy::kBinaryHeap, _1, _2, _3, _4)},
+        {"Bucket queue A* (3_27)", std::bind(OpenListAStar, OpenListPolicy::kBucketQueue, _1, _2, _3, _4)},
+    };
+}
+
+/**
+ * Check that a reported path is a walk of 4-connected free cells from init to
+ * goal with exactly `cost` moves. Returns an empty string when it is valid.
+ */
+string CheckPath(const vector<vector<State>> &grid, int init[2], int goal[2], int cost,
+                 const vector<vector<int>> &path)
+{
+    if (cost < 0)
+        return path.empty() ? "" : "path returned for an unreachable goal";
+    if (path.size() != cost + 1)
+        return "path has " + std::to_string(path.size() - 1) + " moves but cost " + std::to_string(cost);
+    if (path.front() != vector<int>{init[0], init[1]} || path.back() != vector<int>{goal[0], goal[1]})
+        return "path does not join init and goal";
+    for (int i = 0; i < path.size(); i++)
+    {
+        if (!IsFree(path[i][0], path[i][1], grid))
+            return "path crosses an obstacle";
+        if (i > 0 && Heuristic(path[i - 1][0], path[i - 1][1], path[i][0], path[i][1]) != 1)
+            return "path jumps between non-adjacent cells";
+    }
+    return "";
+}
+
+/**
+ * One board plus one query.
+ */
+struct Case
+{
+    vector<vector<State>> grid;
+    int init[2];
+    int goal[2];
+};
+
+/**
+ * Run one engine on a case and compare it with the oracle. Returns an empty
+ * string when the engine agrees, otherwise a description of the mismatch.
+ */
+string Disagreement(const Engine &engine, Case &c)
+{
+    int expected = ReferenceDijkstra(c.grid, c.init, c.goal);
+    vector<vector<int>> path;
+    int cost = engine.run(c.grid, c.init, c.goal, path);
+    if ((cost < 0) != (expected < 0) || (expected >= 0 && (cost < expected || cost > engine.bound * expected)))
+        return "cost " + std::to_string(cost) + ", reference " + std::to_string(expected);
+    return CheckPath(c.grid, c.init, c.goal, cost, path);
+}
+
+/**
+ * Seeded random board of the given size and obstacle density with a random
+ * query. Init and goal may land on obstacles on purpose.
+ */
+Case RandomCase(std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> size(1, 24);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    int rows = size(rng);
+    int cols = size(rng);
+    double density = coin(rng) * 0.5;
+    Case c{vector<vector<State>>(rows, vector<State>(cols, State::kEmpty)), {0, 0}, {0, 0}};
+    for (auto &row : c.grid)
+        for (auto &cell : row)
+            if (coin(rng) < density)
+                cell = State::kObstacle;
+    c.init[0] = std::uniform_int_distribution<int>(0, rows - 1)(rng);
+    c.init[1] = std::uniform_int_distribution<int>(0, cols - 1)(rng);
+    c.goal[0] = std::uniform_int_distribution<int>(0, rows - 1)(rng);
+    c.goal[1] = std::uniform_int_distribution<int>(0, cols - 1)(rng);
+    return c;
+}
+
+/**
+ * Drop row or column `index` from a case, or return false if it holds init or goal.
+ */
+bool RemoveLine(Case &c, bool row, int index)
+{
+    int a = row ? 0 : 1;
+    if (c.init[a] == index || c.goal[a] == index)
+        return false;
+    if (row)
+    {
+        if (c.grid.size() == 1)
+            return false;
+        c.grid.erase(c.grid.begin() + index);
+    }
+    else
+    {
+        if (c.grid[0].size() == 1)
+            return false;
+        for (auto &r : c.grid)
+            r.erase(r.begin() + index);
+    }
+    if (c.init[a] > index)
+        c.init[a]--;
+    if (c.goal[a] > index)
+        c.goal[a]--;
+    return true;
+}
+
+/**
+ * Shrink a failing case to a small reproducer: repeatedly delete whole rows
+ * and columns, then clear single obstacles, keeping every change after which
+ * the engine still disagrees with the oracle.
+ */
+Case Shrink(const Engine &engine, Case failing)
+{
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (int row = 0; row < 2; row++)
+        {
+            int lines = row ? failing.grid.size() : failing.grid[0].size();
+            for (int i = lines - 1; i >= 0; i--)
+            {
+                Case smaller = failing;
+                if (RemoveLine(smaller, row, i) && !Disagreement(engine, smaller).empty())
+                {
+                    failing = smaller;
+                    progress = true;
+                }
+            }
+        }
+        for (int x = 0; x < failing.grid.size(); x++)
+        {
+            for (int y = 0; y < failing.grid[0].size(); y++)
+            {
+                if (failing.grid[x][y] != State::kObstacle)
+                    continue;
+                failing.grid[x][y] = State::kEmpty;
+                if (!Disagreement(engine, failing).empty())
+                    progress = true;
+                else
+                    failing.grid[x][y] = State::kObstacle;
+            }
+        }
+    }
+    return failing;
+}
+
+// Print a board in the same format as ../files/1.board
+void PrintBoardFile(const vector<vector<State>> &grid)
+{
+    for (const auto &row : grid)
+    {
+        for (auto cell : row)
+            cout << (cell == State::kObstacle ? 1 : 0) << ",";
+        cout << "\n";
+    }
+}
+
+/**
+ * Run every engine on `n_cases` seeded random cases. The first failure of
+ * each engine is shrunk and printed. Returns the number of failing engines.
+ */
+int RunDifferential(const vector<Engine> &engines, int n_cases, unsigned seed)
+{
+    int failing_engines = 0;
+    for (const auto &engine : engines)
+    {
+        std::mt19937 rng(seed);
+        int failures = 0;
+        Case first;
+        string reason;
+        for (int i = 0; i < n_cases; i++)
+        {
+            Case c = RandomCase(rng);
+            string why = Disagreement(engine, c);
+            if (why.empty())
+                continue;
+            if (failures++ == 0)
+            {
+                first = c;
+                reason = why;
+            }
+        }
+        cout << engine.name << ": " << n_cases - failures << "/" << n_cases << " agree with Dijkstra\n";
+        if (failures == 0)
+            continue;
+
+        failing_engines++;
+        Case minimal = Shrink(engine, first);
+        cout << "  first failure: " << reason << "\n";
+        cout << "  minimal reproducer (seed " << seed << "), init {" << minimal.init[0] << "," << minimal.init[1]
+             << "} goal {" << minimal.goal[0] << "," << minimal.goal[1] << "}: " << Disagreement(engine, minimal)
+             << "\n";
+        PrintBoardFile(minimal.grid);
+    }
+    return failing_engines;
+}
+
+/**
+ * Cases that exposed a bug or cover an edge case, replayed for every engine
+ * on each run. Random boards are kept as the seed that RandomCase turns into
+ * them, so they stay reproducible without storing the boards.
+ */
+vector<Case> RegressionCases()
+{
+    const State o = State::kObstacle;
+    const State e = State::kEmpty;
+    vector<Case> cases;
+    // The lesson board, cost 11.
+    cases.push_back(Case{ReadBoardFile("../files/1.board"), {0, 0}, {4, 5}});
+    // Start on an obstacle: the weighted and open list engines used to plan from it.
+    cases.push_back(Case{{{e, e}, {e, o}}, {1, 1}, {0, 0}});
+    // Goal on an obstacle, goal walled off, and a start that is the goal.
+    cases.push_back(Case{{{e, e}, {e, o}}, {0, 0}, {1, 1}});
+    cases.push_back(Case{{{e, o, e}, {e, o, e}}, {0, 0}, {1, 2}});
+    cases.push_back(Case{{{e}}, {0, 0}, {0, 0}});
+    // Weighted A* at w = 1.5 returns a longer path than optimal (seeds 235,
+    // 293, 332); seed 6 has a long detour on a 17x22 board.
+    for (unsigned seed : {6, 235, 293, 332})
+    {
+        std::mt19937 rng(seed);
+        cases.push_back(RandomCase(rng));
+    }
+    return cases;
+}
+
+/**
+ * Run every engine on the regression cases. Returns the number of failing engines.
+ */
+int RunRegressions(const vector<Engine> &engines)
+{
+    auto cases = RegressionCases();
+    int failing_engines = 0;
+    for (const auto &engine : engines)
+    {
+        int failures = 0;
+        for (int i = 0; i < cases.size(); i++)
+        {
+            string why = Disagreement(engine, cases[i]);
+            if (why.empty())
+                continue;
+            if (failures++ == 0)
+                cout << engine.name << ": regression case " << i << " fails: " << why << "\n";
+        }
+        failing_engines += failures > 0;
+    }
+    cout << "Regression cases: " << engines.size() - failing_engines << "/" << engines.size()
+         << " engines pass all " << cases.size() << "\n";
+    return failing_engines;
+}
+
+#include "test.cpp"
+
+int main(int argc, char *argv[])
+{
+    // Usage: ./a.out [number of cases] [seed]
+    int n_cases = argc > 1 ? std::atoi(argv[1]) : 2000;
+    unsigned seed = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+    // Tests
+    bool tests_passed = TestReferenceDijkstra();
+    tests_passed &= TestCheckPath();
+    tests_passed &= TestShrink();
+
+    cout << "==========================================================\n";
+    auto engines = AllEngines();
+    int failing = RunRegressions(engines);
+    failing += RunDifferential(engines, n_cases, seed);
+    return tests_passed && failing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
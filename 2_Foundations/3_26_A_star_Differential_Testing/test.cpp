@@ -0,0 +1,125 @@
+void PrintVectorOfVectors(vector<vector<int>> v)
+{
+    for (auto row : v)
+    {
+        cout << "{ ";
+        for (auto col : row)
+        {
+            cout << col << " ";
+        }
+        cout << "}"
+             << "\n";
+    }
+}
+
+// A broken planner for the harness tests: it drives straight through obstacles.
+int ObstacleBlindEngine(const vector<vector<State>> & /* grid */, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    path.clear();
+    int x = init[0];
+    int y = init[1];
+    path.push_back(vector<int>{x, y});
+    while (x != goal[0] || y != goal[1])
+    {
+        if (x != goal[0])
+            x += goal[0] > x ? 1 : -1;
+        else
+            y += goal[1] > y ? 1 : -1;
+        path.push_back(vector<int>{x, y});
+    }
+    return path.size() - 1;
+}
+
+bool TestReferenceDijkstra()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ReferenceDijkstra Function Test: ";
+    auto board = ReadBoardFile("../files/1.board");
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    int blocked[2]{0, 1};
+
+    bool passed = ReferenceDijkstra(board, init, goal) == 11 && ReferenceDijkstra(board, init, blocked) == -1;
+    if (!passed)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "ReferenceDijkstra(board, {0,0}, {4,5}) = " << ReferenceDijkstra(board, init, goal) << "\n";
+        cout << "Correct result: 11"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return passed;
+}
+
+bool TestCheckPath()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "CheckPath Function Test: ";
+    auto board = ReadBoardFile("../files/1.board");
+    int init[2]{0, 0};
+    int goal[2]{2, 0};
+    vector<vector<int>> good{{0, 0}, {1, 0}, {2, 0}};
+    vector<vector<int>> jump{{0, 0}, {2, 0}};
+    vector<vector<int>> wall{{0, 0}, {0, 1}, {1, 1}, {1, 0}, {2, 0}};
+
+    bool passed = CheckPath(board, init, goal, 2, good).empty() && !CheckPath(board, init, goal, 1, jump).empty() &&
+                  !CheckPath(board, init, goal, 4, wall).empty();
+    if (!passed)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Only this path should be accepted: "
+             << "\n";
+        PrintVectorOfVectors(good);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return passed;
+}
+
+bool TestShrink()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Shrink Function Test: ";
+    Engine blind{"Obstacle blind", ObstacleBlindEngine};
+    std::mt19937 rng(3);
+    Case failing = RandomCase(rng);
+    while (Disagreement(blind, failing).empty())
+        failing = RandomCase(rng);
+    Case minimal = Shrink(blind, failing);
+
+    bool passed = !Disagreement(blind, minimal).empty() && minimal.grid.size() * minimal.grid[0].size() <= 3;
+    if (!passed)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Shrunk board still has " << minimal.grid.size() << "x" << minimal.grid[0].size() << " cells: "
+             << "\n";
+        PrintBoardFile(minimal.grid);
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return passed;
+}
@@ -0,0 +1,370 @@
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/**
+ * A* over a binary heap or a bucket queue, with optional step costs. The
+ * engine has its own namespace so the differential tests in
+ * ../3_26_A_star_Differential_Testing can build it next to the others.
+ */
+namespace bucket_queue
+{
+using std::abs;
+using std::cout;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+const double kNoCost = std::numeric_limits<double>::infinity();
+
+// Calculate the manhattan distance
+inline int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * Check that a cell is valid: on the grid and not an obstacle.
+ */
+inline bool CheckValidCell(int x, int y, const vector<vector<State>> &grid)
+{
+    bool on_grid_x = (x >= 0 && x < grid.size());
+    bool on_grid_y = (y >= 0 && y < grid[0].size());
+    if (on_grid_x && on_grid_y)
+        return grid[x][y] != State::kObstacle;
+    return false;
+}
+
+/**
+ * Data structure used for the open list. kAuto picks the bucket queue when
+ * the step costs fit it (see FitsBucketQueue) and the binary heap otherwise.
+ */
+enum class OpenListPolicy
+{
+    kAuto,
+    kBinaryHeap,
+    kBucketQueue
+};
+
+/**
+ * Binary heap ordered by f, ties go to the deeper node.
+ */
+class HeapOpenList
+{
+  public:
+    void Push(int cell, double g, double f)
+    {
+        heap.push_back(Entry{f, g, cell});
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    bool Empty() const { return heap.empty(); }
+
+    int Pop()
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        int cell = heap.back().cell;
+        heap.pop_back();
+        return cell;
+    }
+
+  private:
+    struct Entry
+    {
+        double f;
+        double g;
+        int cell;
+        bool operator<(const Entry &other) const
+        {
+            return f > other.f || (f == other.f && g < other.g);
+        }
+    };
+    vector<Entry> heap;
+};
+
+/**
+ * Dial's bucket queue: one bucket of cells per integer f value. A step of
+ * cost c changes the manhattan distance by 1, so a cell pushed while the
+ * cursor is at f has an f between f and f + c + 1. With steps costing 1 to
+ * max_step the buckets therefore form a ring of max_step + 2, and f must
+ * never be pushed behind the cursor or past the ring. The bucket under the
+ * cursor is spread over one FIFO queue per h = f - g, and the smallest h is
+ * popped first, so ties on f go to the deeper node as in HeapOpenList while
+ * push and pop stay O(1).
+ */
+class BucketOpenList
+{
+  public:
+    explicit BucketOpenList(int max_step = 1) : buckets(max_step + 2) {}
+
+    void Push(int cell, double g, double f)
+    {
+        int index = static_cast<int>(f);
+        if (current < 0)
+            current = index;
+        if (index == current)
+            PushLevel(cell, index - static_cast<int>(g));
+        else
+            buckets[index % buckets.size()].push_back(Entry{static_cast<int>(g), cell});
+        size++;
+    }
+
+    bool Empty() const { return size == 0; }
+
+    int Pop()
+    {
+        while (level_size == 0)
+        {
+            current++;
+            Load();
+        }
+        while (level[min_h].head == level[min_h].cells.size())
+            min_h++;
+        Level &queue = level[min_h];
+        int cell = queue.cells[queue.head++];
+        if (queue.head == queue.cells.size())
+        {
+            queue.cells.clear();
+            queue.head = 0;
+        }
+        level_size--;
+        size--;
+        return cell;
+    }
+
+  private:
+    struct Entry
+    {
+        int g;
+        int cell;
+    };
+
+    struct Level
+    {
+        vector<int> cells;
+        int head = 0; // cells before head have been popped
+    };
+
+    void PushLevel(int cell, int h)
+    {
+        if (h >= level.size())
+            level.resize(h + 1);
+        level[h].cells.push_back(cell);
+        min_h = std::min(min_h, h);
+        level_size++;
+    }
+
+    // Spread the bucket under the cursor over the per-h queues.
+    void Load()
+    {
+        min_h = level.size();
+        auto &bucket = buckets[current % buckets.size()];
+        for (const auto &entry : bucket)
+            PushLevel(entry.cell, current - entry.g);
+        bucket.clear();
+    }
+
+    vector<vector<Entry>> buckets; // ring of cells with f above the cursor
+    vector<Level> level;           // cells with f at the cursor, by h
+    int current = -1; // f under the cursor, set by the first push
+    int min_h = 0;
+    int level_size = 0;
+    int size = 0;
+};
+
+// Largest step cost the bucket queue accepts; the ring has one bucket per cost.
+const double kMaxBucketStep = 1 << 16;
+
+/**
+ * Largest step cost in `cost`, 1 if there is no cost map.
+ */
+inline double MaxStepCost(const vector<vector<double>> *cost)
+{
+    double max_cost = 1.0;
+    if (cost != nullptr)
+        for (const auto &row : *cost)
+            for (double c : row)
+                max_cost = std::max(max_cost, c);
+    return max_cost;
+}
+
+/**
+ * True if the bucket queue can run a search on `grid`: every step cost is a
+ * whole number between 1 and kMaxBucketStep, and the f of a path through
+ * every cell still fits in an int. No cost map means every step costs 1.
+ */
+inline bool FitsBucketQueue(const vector<vector<State>> &grid, const vector<vector<double>> *cost)
+{
+    if (cost != nullptr)
+    {
+        for (const auto &row : *cost)
+        {
+            for (double c : row)
+            {
+                // Also false for NaN.
+                if (!(c >= 1.0 && c <= kMaxBucketStep) || c != std::floor(c))
+                    return false;
+            }
+        }
+    }
+    double rows = grid.size();
+    double cols = grid.empty() ? 0 : grid[0].size();
+    return MaxStepCost(cost) * rows * cols + rows + cols <= std::numeric_limits<int>::max();
+}
+
+/**
+ * Resolve the open list for a search. kAuto and kBucketQueue both fall back
+ * to the binary heap when the costs do not fit the bucket queue.
+ */
+inline OpenListPolicy ChooseOpenList(OpenListPolicy policy, const vector<vector<State>> &grid,
+                                     const vector<vector<double>> *cost)
+{
+    if (policy == OpenListPolicy::kBinaryHeap || !FitsBucketQueue(grid, cost))
+        return OpenListPolicy::kBinaryHeap;
+    return OpenListPolicy::kBucketQueue;
+}
+
+/**
+ * Outcome of a search: the path from init to goal, its cost (kNoCost if
+ * the goal is unreachable), the open list that was used and the number of
+ * cells expanded.
+ */
+struct SearchResult
+{
+    vector<vector<int>> path;
+    double cost;
+    OpenListPolicy policy;
+    int expansions;
+};
+
+/**
+ * A* over any open list with Push(cell, g, f), Pop() and Empty(). Entering a
+ * cell costs cost[x][y], which must be at least 1 for the manhattan distance
+ * to stay consistent. Improved cells are pushed again and the stale copy is
+ * skipped when it surfaces after the cell was closed.
+ */
+template <typename OpenList>
+SearchResult SearchWith(OpenList &open, const vector<vector<State>> &grid, int init[2], int goal[2],
+                        const vector<vector<double>> *cost)
+{
+    int rows = grid.size();
+    int cols = grid[0].size();
+    vector<double> g(rows * cols, kNoCost);
+    vector<int> parent(rows * cols, -1);
+    vector<char> closed(rows * cols, 0);
+    SearchResult result{{}, kNoCost, OpenListPolicy::kAuto, 0};
+    if (!CheckValidCell(init[0], init[1], grid) || !CheckValidCell(goal[0], goal[1], grid))
+        return result;
+
+    int start = init[0] * cols + init[1];
+    int target = goal[0] * cols + goal[1];
+    g[start] = 0;
+    parent[start] = start;
+    open.Push(start, 0, Heuristic(init[0], init[1], goal[0], goal[1]));
+
+    while (!open.Empty())
+    {
+        int cell = open.Pop();
+        if (closed[cell])
+            continue;
+        closed[cell] = 1;
+        result.expansions++;
+        if (cell == target)
+            break;
+
+        int x = cell / cols;
+        int y = cell % cols;
+        for (int i = 0; i < 4; i++)
+        {
+            int x2 = x + delta[i][0];
+            int y2 = y + delta[i][1];
+            if (!CheckValidCell(x2, y2, grid))
+                continue;
+            int next = x2 * cols + y2;
+            double g2 = g[cell] + (cost ? (*cost)[x2][y2] : 1.0);
+            if (closed[next] || g2 >= g[next])
+                continue;
+            g[next] = g2;
+            parent[next] = cell;
+            open.Push(next, g2, g2 + Heuristic(x2, y2, goal[0], goal[1]));
+        }
+    }
+
+    if (g[target] == kNoCost)
+        return result;
+    result.cost = g[target];
+    for (int cell = target;; cell = parent[cell])
+    {
+        result.path.push_back(vector<int>{cell / cols, cell % cols});
+        if (parent[cell] == cell)
+            break;
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    return result;
+}
+
+/**
+ * Find a cheapest path from init to goal with the selected open list.
+ * result.policy tells which open list was actually used.
+ */
+inline SearchResult FindPath(const vector<vector<State>> &grid, int init[2], int goal[2],
+                             OpenListPolicy policy = OpenListPolicy::kAuto,
+                             const vector<vector<double>> *cost = nullptr)
+{
+    SearchResult result;
+    policy = ChooseOpenList(policy, grid, cost);
+    if (policy == OpenListPolicy::kBucketQueue)
+    {
+        BucketOpenList open(MaxStepCost(cost));
+        result = SearchWith(open, grid, init, goal, cost);
+    }
+    else
+    {
+        HeapOpenList open;
+        result = SearchWith(open, grid, init, goal, cost);
+    }
+    result.policy = policy;
+    return result;
+}
+
+/**
+ * Implementation of A* search algorithm
+ */
+inline vector<vector<State>> Search(vector<vector<State>> grid, int init[2], int goal[2],
+                                    OpenListPolicy policy = OpenListPolicy::kAuto,
+                                    const vector<vector<double>> *cost = nullptr)
+{
+    auto result = FindPath(grid, init, goal, policy, cost);
+    if (result.path.empty())
+    {
+        cout << "No path found!"
+             << "\n";
+        return std::vector<vector<State>>{};
+    }
+    for (const auto &p : result.path)
+        grid[p[0]][p[1]] = State::kPath;
+    grid[init[0]][init[1]] = State::kStart;
+    grid[goal[0]][goal[1]] = State::kFinish;
+    return grid;
+}
+
+} // namespace bucket_queue
+
+#endif // BUCKET_QUEUE_H
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bucket_queue.h"
+
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+using namespace bucket_queue;
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Build a square board with randomly placed obstacles, keeping the corners free.
+ */
+vector<vector<State>> RandomBoard(int side, double density, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < density)
+                cell = State::kObstacle;
+    grid[0][0] = State::kEmpty;
+    grid[side - 1][side - 1] = State::kEmpty;
+    return grid;
+}
+
+/**
+ * Random terrain costs between 1 and max_cost, whole numbers if `integer`.
+ */
+vector<vector<double>> RandomCosts(int side, int max_cost, bool integer, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(1.0, max_cost);
+    vector<vector<double>> cost(side, vector<double>(side));
+    for (auto &row : cost)
+        for (auto &c : row)
+            c = integer ? std::round(uniform(rng)) : uniform(rng);
+    return cost;
+}
+
+/**
+ * Time the same queries with both open lists, on unit costs and on integer
+ * terrain costs.
+ */
+void BenchmarkOpenLists()
+{
+    cout << "==========================================================\n";
+    cout << "Open lists on a 1000x1000 board\n";
+    int side = 1000;
+    auto board = RandomBoard(side, 0.2, 4);
+    auto terrain = RandomCosts(side, 9, true, 4);
+    int init[2]{0, 0};
+    int goal[2]{side - 1, side - 1};
+
+    const char *names[2]{"Binary heap", "Bucket queue"};
+    OpenListPolicy policies[2]{OpenListPolicy::kBinaryHeap, OpenListPolicy::kBucketQueue};
+    const vector<vector<double>> *maps[2]{nullptr, &terrain};
+    const char *map_names[2]{"unit costs", "costs 1-9"};
+    for (int m = 0; m < 2; m++)
+    {
+        for (int p = 0; p < 2; p++)
+        {
+            auto t1 = std::chrono::high_resolution_clock::now();
+            SearchResult result;
+            for (int run = 0; run < 5; run++)
+                result = FindPath(board, init, goal, policies[p], maps[m]);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(t2 - t1).count() / 5;
+            cout << names[p] << ", " << map_names[m] << ": cost " << result.cost << ", " << result.expansions
+                 << " expansions, " << ms << " ms\n";
+        }
+    }
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    auto solution = Search(board, init, goal);
+    PrintBoard(solution);
+    // Tests
+    TestBucketOpenList();
+    TestChooseOpenList();
+    TestSearchPolicies();
+    BenchmarkOpenLists();
+}
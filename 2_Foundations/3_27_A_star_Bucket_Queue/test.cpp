@@ -0,0 +1,175 @@
+/**
+ * Reference path cost by Dijkstra's algorithm, kNoCost if unreachable.
+ */
+double DijkstraCost(const vector<vector<State>> &grid, int init[2], int goal[2], const vector<vector<double>> *cost)
+{
+    int cols = grid[0].size();
+    vector<double> dist(grid.size() * cols, kNoCost);
+    std::priority_queue<std::pair<double, int>, vector<std::pair<double, int>>, std::greater<std::pair<double, int>>>
+        queue;
+    dist[init[0] * cols + init[1]] = 0;
+    queue.push({0, init[0] * cols + init[1]});
+    while (!queue.empty())
+    {
+        auto [d, cell] = queue.top();
+        queue.pop();
+        if (d > dist[cell])
+            continue;
+        for (auto delta_i : delta)
+        {
+            int x2 = cell / cols + delta_i[0];
+            int y2 = cell % cols + delta_i[1];
+            if (!CheckValidCell(x2, y2, grid))
+                continue;
+            double d2 = d + (cost ? (*cost)[x2][y2] : 1.0);
+            if (d2 < dist[x2 * cols + y2])
+            {
+                dist[x2 * cols + y2] = d2;
+                queue.push({d2, x2 * cols + y2});
+            }
+        }
+    }
+    return dist[goal[0] * cols + goal[1]];
+}
+
+void TestBucketOpenList()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "BucketOpenList Test: ";
+    BucketOpenList open(1);
+    open.Push(3, 3, 5);
+    open.Push(1, 0, 7);
+    open.Push(2, 1, 5);
+    open.Push(4, 2, 6);
+    open.Push(5, 1, 5);
+    vector<int> order;
+    while (!open.Empty())
+        order.push_back(open.Pop());
+    vector<int> expected{3, 2, 5, 4, 1};
+
+    if (order != expected)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Cells must come out by f, deepest first within equal f. Got: ";
+        for (int cell : order)
+            cout << cell << " ";
+        cout << "\n";
+        cout << "Correct order: 3 2 5 4 1"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestChooseOpenList()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "ChooseOpenList Function Test: ";
+    vector<vector<State>> grid(10, vector<State>(10, State::kEmpty));
+    auto integer = RandomCosts(10, 9, true, 1);
+    auto fractional = RandomCosts(10, 9, false, 1);
+    auto negative = integer;
+    negative[3][4] = -2;
+    auto zero = integer;
+    zero[5][5] = 0;
+    auto huge = integer;
+    huge[0][0] = 1e9;
+
+    if (ChooseOpenList(OpenListPolicy::kAuto, grid, nullptr) != OpenListPolicy::kBucketQueue ||
+        ChooseOpenList(OpenListPolicy::kAuto, grid, &integer) != OpenListPolicy::kBucketQueue)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Integer step costs should select the bucket queue."
+             << "\n";
+        cout << "\n";
+    }
+    else if (ChooseOpenList(OpenListPolicy::kAuto, grid, &fractional) != OpenListPolicy::kBinaryHeap ||
+             ChooseOpenList(OpenListPolicy::kBinaryHeap, grid, &integer) != OpenListPolicy::kBinaryHeap)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Fractional step costs, or an explicit choice, should select the binary heap."
+             << "\n";
+        cout << "\n";
+    }
+    else if (ChooseOpenList(OpenListPolicy::kBucketQueue, grid, &negative) != OpenListPolicy::kBinaryHeap ||
+             ChooseOpenList(OpenListPolicy::kBucketQueue, grid, &zero) != OpenListPolicy::kBinaryHeap ||
+             ChooseOpenList(OpenListPolicy::kBucketQueue, grid, &huge) != OpenListPolicy::kBinaryHeap)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Costs below 1, or too large for the buckets, should fall back to the binary heap."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestSearchPolicies()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Search Open List Policies Test: ";
+    std::mt19937 rng(42);
+    string failure;
+    for (int trial = 0; trial < 200 && failure.empty(); trial++)
+    {
+        int side = 2 + rng() % 40;
+        auto board = RandomBoard(side, 0.3, rng());
+        auto terrain = RandomCosts(side, 9, trial % 2 == 0, rng());
+        const vector<vector<double>> *cost = trial % 3 == 0 ? nullptr : &terrain;
+        int init[2]{0, 0};
+        int goal[2]{side - 1, side - 1};
+        double expected = DijkstraCost(board, init, goal, cost);
+        for (auto policy : {OpenListPolicy::kBinaryHeap, OpenListPolicy::kBucketQueue})
+        {
+            auto result = FindPath(board, init, goal, policy, cost);
+            if (result.policy != ChooseOpenList(policy, board, cost))
+                failure = "trial " + std::to_string(trial) + ": wrong open list";
+            double walked = 0;
+            for (int i = 1; i < result.path.size(); i++)
+                walked += cost ? (*cost)[result.path[i][0]][result.path[i][1]] : 1.0;
+            if (std::abs(result.cost - expected) > 1e-9 ||
+                (!result.path.empty() && std::abs(walked - expected) > 1e-9))
+            {
+                failure = "trial " + std::to_string(trial) + ": cost " + std::to_string(result.cost) +
+                          ", Dijkstra " + std::to_string(expected);
+            }
+        }
+    }
+
+    if (!failure.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << failure << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
@@ -0,0 +1,80 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+/**
+ * Lock-free histogram with power-of-two buckets: bucket i counts values in
+ * [2^(i-1), 2^i), bucket 0 counts zero. Any thread may Record concurrently.
+ */
+class Histogram
+{
+  public:
+    static const int kBuckets = 40;
+
+    Histogram()
+    {
+        for (auto &count : counts)
+            count.store(0, std::memory_order_relaxed);
+    }
+
+    void Record(uint64_t value)
+    {
+        int bucket = 0;
+        while (value > 0 && bucket < kBuckets - 1)
+        {
+            value >>= 1;
+            bucket++;
+        }
+        counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t Count() const
+    {
+        uint64_t total = 0;
+        for (const auto &count : counts)
+            total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Upper edge of the bucket holding the p-th percentile
+    uint64_t Percentile(double p) const
+    {
+        uint64_t rank = static_cast<uint64_t>(Count() * p / 100.0);
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++)
+        {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen > rank)
+                return i == 0 ? 0 : (uint64_t{1} << i) - 1;
+        }
+        return (uint64_t{1} << (kBuckets - 1)) - 1;
+    }
+
+    // One line per non-empty bucket, followed by p50/p99/p99.9
+    std::string Format(const std::string &title, const std::string &unit) const
+    {
+        std::ostringstream out;
+        out << title << " (" << Count() << " samples)\n";
+        for (int i = 0; i < kBuckets; i++)
+        {
+            uint64_t count = counts[i].load(std::memory_order_relaxed);
+            if (count == 0)
+                continue;
+            uint64_t low = i == 0 ? 0 : uint64_t{1} << (i - 1);
+            uint64_t high = i == 0 ? 0 : (uint64_t{1} << i) - 1;
+            out << "  " << low << "-" << high << " " << unit << ": " << count << "\n";
+        }
+        out << "  p50 <= " << Percentile(50) << " " << unit << ", p99 <= " << Percentile(99) << " " << unit
+            << ", p99.9 <= " << Percentile(99.9) << " " << unit << "\n";
+        return out.str();
+    }
+
+  private:
+    std::atomic<uint64_t> counts[kBuckets];
+};
+
+#endif // HISTOGRAM_H
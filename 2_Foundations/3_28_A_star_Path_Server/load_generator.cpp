@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "histogram.h"
+#include "planner.h"
+#include "protocol.h"
+
+using std::cout;
+using std::string;
+using std::vector;
+
+using Clock = std::chrono::steady_clock;
+
+int Connect(const string &socket_path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+        return fd;
+    if (fd >= 0)
+        close(fd);
+    return -1;
+}
+
+/**
+ * Send `n_queries` random path queries over one connection, keeping up to
+ * `depth` of them in flight, and record each round trip in `latency` (us).
+ */
+void RunClient(const string &socket_path, const vector<int> &free_cells, int cols, int n_queries, int depth,
+               unsigned seed, Histogram &latency, std::atomic<long> &found, std::atomic<int> &errors)
+{
+    int fd = Connect(socket_path);
+    if (fd < 0)
+    {
+        errors++;
+        return;
+    }
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, free_cells.size() - 1);
+    vector<Clock::time_point> sent(n_queries);
+    vector<char> payload;
+    int next = 0;
+    int done = 0;
+    while (done < n_queries)
+    {
+        while (next < n_queries && next - done < depth)
+        {
+            int from = free_cells[pick(rng)];
+            int to = free_cells[pick(rng)];
+            Request request{static_cast<uint32_t>(next), kPathQuery, {}, {}, {}};
+            request.init[0] = from / cols;
+            request.init[1] = from % cols;
+            request.goal[0] = to / cols;
+            request.goal[1] = to % cols;
+            sent[next] = Clock::now();
+            if (!WriteAll(fd, &request, sizeof(request)))
+                break;
+            next++;
+        }
+
+        ResponseHeader header;
+        payload.resize(0);
+        if (!ReadAll(fd, &header, sizeof(header)))
+            break;
+        payload.resize(header.length);
+        if (!ReadAll(fd, payload.data(), payload.size()) || header.id >= static_cast<uint32_t>(n_queries))
+            break;
+        latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sent[header.id]).count());
+        found += header.cost >= 0;
+        done++;
+    }
+    if (done < n_queries)
+        errors++;
+    close(fd);
+}
+
+// Ask the server for its histograms
+string FetchServerStats(const string &socket_path)
+{
+    int fd = Connect(socket_path);
+    if (fd < 0)
+        return "";
+    Request request{0, kStatsQuery, {}, {}, {}};
+    ResponseHeader header;
+    string text;
+    if (WriteAll(fd, &request, sizeof(request)) && ReadAll(fd, &header, sizeof(header)))
+    {
+        text.resize(header.length);
+        if (!ReadAll(fd, &text[0], text.size()))
+            text.clear();
+    }
+    close(fd);
+    return text;
+}
+
+/**
+ * Usage: load_generator [board | random:<side>] [socket] [clients] [queries per client] [in flight]
+ * Build: g++ -std=c++17 -O2 -pthread load_generator.cpp planner.cpp -o load_generator
+ */
+int main(int argc, char *argv[])
+{
+    string board_spec = argc > 1 ? argv[1] : "../files/1.board";
+    string socket_path = argc > 2 ? argv[2] : "/tmp/path_server.sock";
+    int n_clients = argc > 3 ? std::atoi(argv[3]) : 8;
+    int n_queries = argc > 4 ? std::atoi(argv[4]) : 10000;
+    int depth = argc > 5 ? std::atoi(argv[5]) : 4;
+
+    // Same board as the server, so queries start and end on free cells.
+    auto grid = LoadBoard(board_spec);
+    vector<int> free_cells;
+    int cols = grid.empty() ? 0 : grid[0].size();
+    for (int x = 0; x < static_cast<int>(grid.size()); x++)
+        for (int y = 0; y < cols; y++)
+            if (grid[x][y] != State::kObstacle)
+                free_cells.push_back(x * cols + y);
+    if (free_cells.empty())
+    {
+        std::cerr << "Could not load board " << board_spec << "\n";
+        return EXIT_FAILURE;
+    }
+
+    Histogram latency;
+    std::atomic<long> found{0};
+    std::atomic<int> errors{0};
+    vector<std::thread> clients;
+    auto start = Clock::now();
+    for (int c = 0; c < n_clients; c++)
+        clients.emplace_back(RunClient, std::cref(socket_path), std::cref(free_cells), cols, n_queries, depth, c + 1,
+                             std::ref(latency), std::ref(found), std::ref(errors));
+    for (auto &client : clients)
+        client.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (errors > 0)
+        std::cerr << errors << " of " << n_clients << " clients failed\n";
+    cout << n_clients << " clients x " << n_queries << " queries, " << depth << " in flight each\n";
+    cout << latency.Count() << " answered (" << found << " with a path) in " << seconds << " s, "
+         << latency.Count() / seconds << " queries/s\n";
+    cout << latency.Format("Round trip", "us");
+    cout << "Server side:\n" << FetchServerStats(socket_path);
+    return errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
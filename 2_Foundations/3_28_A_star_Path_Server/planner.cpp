@@ -0,0 +1,179 @@
+#include "planner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using std::string;
+using std::vector;
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    std::istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    std::ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+vector<vector<State>> LoadBoard(string spec)
+{
+    const string prefix = "random:";
+    if (spec.compare(0, prefix.size(), prefix) != 0)
+    {
+        auto board = ReadBoardFile(spec);
+        if (board.size() > kMaxSide || (!board.empty() && board[0].size() > kMaxSide))
+        {
+            std::cerr << "Board " << spec << " is larger than " << kMaxSide << " cells on a side\n";
+            return {};
+        }
+        return board;
+    }
+
+    char *end = nullptr;
+    long side = std::strtol(spec.c_str() + prefix.size(), &end, 10);
+    if (end == spec.c_str() + prefix.size() || *end != '\0' || side < 1 || side > kMaxSide)
+    {
+        std::cerr << "Random board side must be a number from 1 to " << kMaxSide << ", got " << spec << "\n";
+        return {};
+    }
+    // Fixed seed, so the server and the load generator build the same board.
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < 0.2)
+                cell = State::kObstacle;
+    return grid;
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return std::abs(x2 - x1) + std::abs(y2 - y1);
+}
+
+Planner::Planner(const vector<vector<State>> &grid)
+    : grid(grid), rows(grid.size()), cols(grid.empty() ? 0 : grid[0].size()), g(rows * cols),
+      parent(rows * cols), seen(rows * cols, 0), closed(rows * cols, 0)
+{
+}
+
+int Planner::Search(int init[2], int goal[2], vector<int16_t> &path)
+{
+    path.clear();
+    for (int i = 0; i < 2; i++)
+    {
+        if (init[i] < 0 || goal[i] < 0 || init[i] >= (i == 0 ? rows : cols) || goal[i] >= (i == 0 ? rows : cols))
+            return -1;
+    }
+    if (grid[init[0]][init[1]] == State::kObstacle || grid[goal[0]][goal[1]] == State::kObstacle)
+        return -1;
+
+    generation++;
+    for (auto &bucket : buckets)
+        bucket.clear();
+    int start = init[0] * cols + init[1];
+    int target = goal[0] * cols + goal[1];
+    g[start] = 0;
+    parent[start] = start;
+    seen[start] = generation;
+
+    // Unit steps and a consistent heuristic: f only grows, so the bucket
+    // cursor never moves back.
+    int f = Heuristic(init[0], init[1], goal[0], goal[1]);
+    if (f >= static_cast<int>(buckets.size()))
+        buckets.resize(f + 1);
+    buckets[f].push_back(start);
+    bool found = false;
+    while (!found && f < static_cast<int>(buckets.size()))
+    {
+        if (buckets[f].empty())
+        {
+            f++;
+            continue;
+        }
+        int cell = buckets[f].back();
+        buckets[f].pop_back();
+        if (closed[cell] == generation)
+            continue;
+        closed[cell] = generation;
+        if (cell == target)
+        {
+            found = true;
+            break;
+        }
+
+        int x = cell / cols;
+        int y = cell % cols;
+        for (int i = 0; i < 4; i++)
+        {
+            int x2 = x + delta[i][0];
+            int y2 = y + delta[i][1];
+            if (x2 < 0 || x2 >= rows || y2 < 0 || y2 >= cols || grid[x2][y2] == State::kObstacle)
+                continue;
+            int next = x2 * cols + y2;
+            int g2 = g[cell] + 1;
+            if (closed[next] == generation || (seen[next] == generation && g2 >= g[next]))
+                continue;
+            g[next] = g2;
+            parent[next] = cell;
+            seen[next] = generation;
+            int f2 = g2 + Heuristic(x2, y2, goal[0], goal[1]);
+            if (f2 >= static_cast<int>(buckets.size()))
+                buckets.resize(f2 + 1);
+            buckets[f2].push_back(next);
+        }
+    }
+    if (!found)
+        return -1;
+
+    for (int cell = target;; cell = parent[cell])
+    {
+        path.push_back(cell / cols);
+        path.push_back(cell % cols);
+        if (parent[cell] == cell)
+            break;
+    }
+    // Reverse the (x, y) pairs, not the individual coordinates.
+    for (int i = 0, j = path.size() - 2; i < j; i += 2, j -= 2)
+    {
+        std::swap(path[i], path[j]);
+        std::swap(path[i + 1], path[j + 1]);
+    }
+    return g[target];
+}
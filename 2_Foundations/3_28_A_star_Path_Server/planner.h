@@ -0,0 +1,52 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// Largest board side the int16 coordinates of protocol.h can address
+const int kMaxSide = 32767;
+
+// Read a board file, or build a random one when `spec` is "random:<side>".
+// Returns an empty board, after printing why, if the spec is not usable.
+std::vector<std::vector<State>> LoadBoard(std::string spec);
+
+/**
+ * A* over one shared, read-only board. Each worker thread owns a Planner so
+ * the per-cell scratch arrays are allocated once and reused for every query.
+ */
+class Planner
+{
+  public:
+    Planner(const std::vector<std::vector<State>> &grid);
+
+    // Cost of a cheapest path, or -1. `path` receives x, y pairs from init to goal.
+    int Search(int init[2], int goal[2], std::vector<int16_t> &path);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+
+  private:
+    const std::vector<std::vector<State>> &grid;
+    int rows;
+    int cols;
+    std::vector<int> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> seen; // g and parent are valid when seen == generation
+    std::vector<uint32_t> closed;
+    std::vector<std::vector<int>> buckets; // bucket queue indexed by f
+    uint32_t generation = 0;
+};
+
+#endif // PLANNER_H
@@ -0,0 +1,78 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
+
+/**
+ * Wire format between the path server and its clients. Messages are fixed
+ * size headers in host byte order, since a Unix domain socket never leaves
+ * the machine. A client may pipeline any number of requests; responses carry
+ * the request id and can arrive out of order.
+ */
+
+enum MessageType : uint8_t
+{
+    kPathQuery = 1,  // response payload: cost + 1 pairs of int16 x, y
+    kStatsQuery = 2, // response payload: latency histograms as text
+};
+
+struct Request
+{
+    uint32_t id;
+    uint8_t type;
+    uint8_t reserved[3];
+    int16_t init[2];
+    int16_t goal[2];
+};
+
+// ResponseHeader::cost of a path query whose init or goal is off the board
+const int32_t kOffBoard = -2;
+
+struct ResponseHeader
+{
+    uint32_t id;
+    int32_t cost;    // -1 if there is no path, kOffBoard for a bad query
+    uint32_t length; // bytes of payload that follow
+};
+
+static_assert(sizeof(Request) == 16, "Request must stay 16 bytes on the wire");
+static_assert(sizeof(ResponseHeader) == 12, "ResponseHeader must stay 12 bytes on the wire");
+
+// Read exactly `size` bytes. Returns false on end of stream or error.
+inline bool ReadAll(int fd, void *buffer, size_t size)
+{
+    char *p = static_cast<char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Write exactly `size` bytes. Returns false if the peer went away.
+inline bool WriteAll(int fd, const void *buffer, size_t size)
+{
+    const char *p = static_cast<const char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+#endif // PROTOCOL_H
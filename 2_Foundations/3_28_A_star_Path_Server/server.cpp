@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "histogram.h"
+#include "planner.h"
+#include "protocol.h"
+
+using std::cout;
+using std::string;
+using std::vector;
+
+using Clock = std::chrono::steady_clock;
+
+// Bytes of responses a client may leave unread before it is dropped
+const size_t kMaxOutbox = 1 << 20;
+
+/**
+ * One client socket. It is shared by the thread serving the client and by
+ * every query still waiting to be answered, and closed after the last one.
+ * Responses are sent without blocking. Whatever the socket does not take
+ * right away waits in the outbox until the serving thread can flush it, so
+ * a client that stops reading never holds up a worker.
+ */
+struct Connection
+{
+    Connection(int fd) : fd(fd)
+    {
+        if (pipe(wake) < 0)
+            wake[0] = wake[1] = -1;
+        for (int end : wake)
+            if (end >= 0)
+                fcntl(end, F_SETFL, O_NONBLOCK);
+    }
+    ~Connection()
+    {
+        close(fd);
+        for (int end : wake)
+            if (end >= 0)
+                close(end);
+    }
+    int fd;
+    int wake[2];       // pipe the workers use to wake the serving thread
+    std::mutex mutex;  // guards the members below
+    string outbox;     // response bytes the socket has not taken yet
+    int in_flight = 0; // path queries handed to the workers, not answered yet
+    bool reading = true;
+    bool dropped = false;
+};
+
+/**
+ * Send what the socket takes without blocking. Returns the number of bytes
+ * sent, or -1 if the client went away.
+ */
+ssize_t SendSome(int fd, const char *data, size_t size)
+{
+    while (true)
+    {
+        ssize_t n = send(fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n >= 0)
+            return n;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        if (errno != EINTR)
+            return -1;
+    }
+}
+
+// Called with connection.mutex held. shutdown() also wakes the serving thread.
+void Drop(Connection &connection)
+{
+    connection.dropped = true;
+    connection.outbox.clear();
+    shutdown(connection.fd, SHUT_RDWR);
+}
+
+// Called with connection.mutex held. A full pipe already holds a wakeup.
+void Wake(Connection &connection)
+{
+    char byte = 0;
+    if (write(connection.wake[1], &byte, 1) < 0)
+        return;
+}
+
+/**
+ * Queue `size` bytes of responses that answer `answered` path queries.
+ * Never blocks: bytes the socket does not take go to the outbox, and a
+ * client whose outbox would grow past kMaxOutbox is dropped.
+ */
+void Send(Connection &connection, const char *data, size_t size, int answered)
+{
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    connection.in_flight -= answered;
+    if (connection.dropped)
+        return;
+    size_t sent = 0;
+    if (connection.outbox.empty())
+    {
+        ssize_t n = SendSome(connection.fd, data, size);
+        if (n < 0)
+        {
+            Drop(connection);
+            return;
+        }
+        sent = n;
+    }
+    if (sent < size)
+    {
+        if (connection.outbox.size() + (size - sent) > kMaxOutbox)
+        {
+            std::cerr << "Client is not reading its responses, dropping it\n";
+            Drop(connection);
+            return;
+        }
+        if (connection.outbox.empty())
+            Wake(connection);
+        connection.outbox.append(data + sent, size - sent);
+    }
+    // A client that stopped sending is served until its last answer is out.
+    if (!connection.reading && connection.in_flight == 0)
+        Wake(connection);
+}
+
+/**
+ * Hand the outbox to the socket as far as it takes it. Returns false once
+ * the client is gone, or has stopped sending and got every answer.
+ */
+bool Flush(Connection &connection)
+{
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    if (connection.dropped)
+        return false;
+    ssize_t n = SendSome(connection.fd, connection.outbox.data(), connection.outbox.size());
+    if (n < 0)
+    {
+        Drop(connection);
+        return false;
+    }
+    connection.outbox.erase(0, n);
+    return connection.reading || connection.in_flight > 0 || !connection.outbox.empty();
+}
+
+struct Query
+{
+    std::shared_ptr<Connection> connection;
+    Request request;
+    Clock::time_point received;
+};
+
+struct ServerStats
+{
+    Histogram queue_wait;  // received until a worker picked it up, us
+    Histogram search;      // time in Planner::Search, ns
+    Histogram end_to_end;  // received until the response was sent or queued, us
+    Histogram batch_size;  // queries handed to a worker at once
+};
+
+string FormatStats(const ServerStats &stats)
+{
+    return stats.queue_wait.Format("Queue wait", "us") + stats.search.Format("Search", "ns") +
+           stats.end_to_end.Format("End to end", "us") + stats.batch_size.Format("Batch size", "queries");
+}
+
+/**
+ * Queries waiting for a worker. Workers take everything that is pending (up
+ * to a maximum) in one go, so requests that arrive together are served as
+ * one batch under a single lock acquisition and written back together.
+ */
+class BatchQueue
+{
+  public:
+    void Push(Query query)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(query));
+        cond.notify_one();
+    }
+
+    /**
+     * Block until a query is pending, then optionally linger up to `window`
+     * for the batch to fill. Returns an empty batch once the queue is closed.
+     */
+    vector<Query> PopBatch(size_t max_batch, Clock::duration window)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [this] { return !pending.empty() || closed; });
+        if (window > Clock::duration::zero() && pending.size() < max_batch)
+            cond.wait_for(lock, window, [&] { return pending.size() >= max_batch || closed; });
+
+        vector<Query> batch;
+        size_t n = std::min(max_batch, pending.size());
+        batch.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            batch.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+        // Leftovers are someone else's batch.
+        if (!pending.empty())
+            cond.notify_one();
+        return batch;
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        cond.notify_all();
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Query> pending;
+    bool closed = false;
+};
+
+/**
+ * Answer batches until the queue is closed. Responses for the same client are
+ * gathered into one buffer and sent with a single write, which never blocks.
+ */
+void Worker(BatchQueue &queue, const vector<vector<State>> &grid, ServerStats &stats, size_t max_batch,
+            Clock::duration window)
+{
+    Planner planner(grid);
+    vector<int16_t> path;
+    vector<char> out;
+    while (true)
+    {
+        vector<Query> batch = queue.PopBatch(max_batch, window);
+        if (batch.empty())
+            return;
+        stats.batch_size.Record(batch.size());
+        std::stable_sort(batch.begin(), batch.end(), [](const Query &a, const Query &b) {
+            return a.connection.get() < b.connection.get();
+        });
+
+        for (size_t begin = 0, end; begin < batch.size(); begin = end)
+        {
+            out.clear();
+            for (end = begin; end < batch.size() && batch[end].connection == batch[begin].connection; end++)
+            {
+                Query &query = batch[end];
+                auto t1 = Clock::now();
+                stats.queue_wait.Record(
+                    std::chrono::duration_cast<std::chrono::microseconds>(t1 - query.received).count());
+                int init[2]{query.request.init[0], query.request.init[1]};
+                int goal[2]{query.request.goal[0], query.request.goal[1]};
+                int cost = planner.Search(init, goal, path);
+                stats.search.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t1).count());
+
+                ResponseHeader header{query.request.id, cost, static_cast<uint32_t>(path.size() * sizeof(int16_t))};
+                const char *bytes = reinterpret_cast<const char *>(&header);
+                out.insert(out.end(), bytes, bytes + sizeof(header));
+                bytes = reinterpret_cast<const char *>(path.data());
+                out.insert(out.end(), bytes, bytes + header.length);
+            }
+
+            Send(*batch[begin].connection, out.data(), out.size(), end - begin);
+            auto done = Clock::now();
+            for (size_t i = begin; i < end; i++)
+                stats.end_to_end.Record(
+                    std::chrono::duration_cast<std::chrono::microseconds>(done - batch[i].received).count());
+        }
+    }
+}
+
+/**
+ * Handle one request. Path queries on the board go to the workers; stats
+ * queries and queries off the board are answered right here. Returns false
+ * if the client has to be dropped.
+ */
+bool HandleRequest(const std::shared_ptr<Connection> &connection, const Request &request, BatchQueue &queue,
+                   const ServerStats &stats, int rows, int cols)
+{
+    if (request.type == kPathQuery)
+    {
+        bool on_board = true;
+        for (const int16_t *cell : {request.init, request.goal})
+            on_board = on_board && cell[0] >= 0 && cell[0] < rows && cell[1] >= 0 && cell[1] < cols;
+        if (!on_board)
+        {
+            ResponseHeader header{request.id, kOffBoard, 0};
+            Send(*connection, reinterpret_cast<const char *>(&header), sizeof(header), 0);
+            return true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            connection->in_flight++;
+        }
+        queue.Push(Query{connection, request, Clock::now()});
+        return true;
+    }
+    if (request.type == kStatsQuery)
+    {
+        string text = FormatStats(stats);
+        ResponseHeader header{request.id, 0, static_cast<uint32_t>(text.size())};
+        const char *bytes = reinterpret_cast<const char *>(&header);
+        text.insert(text.begin(), bytes, bytes + sizeof(header));
+        Send(*connection, text.data(), text.size(), 0);
+        return true;
+    }
+    std::cerr << "Unknown request type " << int(request.type) << ", dropping client\n";
+    return false;
+}
+
+/**
+ * Serve one client: read its requests and flush its outbox whenever the
+ * socket has room, until it hangs up and has received every answer.
+ */
+void ServeConnection(std::shared_ptr<Connection> connection, BatchQueue &queue, const ServerStats &stats, int rows,
+                     int cols)
+{
+    Connection &client = *connection;
+    if (client.wake[0] < 0)
+        return;
+    vector<char> inbox; // bytes of a request that has not fully arrived
+    char buffer[4096];
+    while (Flush(client))
+    {
+        bool reading, writing;
+        {
+            std::lock_guard<std::mutex> lock(client.mutex);
+            reading = client.reading;
+            writing = !client.outbox.empty();
+        }
+        short events = (reading ? POLLIN : 0) | (writing ? POLLOUT : 0);
+        pollfd fds[2]{{client.fd, events, 0}, {client.wake[0], POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[0].revents & (POLLHUP | POLLERR))
+            break;
+        if (fds[1].revents & POLLIN)
+            while (read(client.wake[0], buffer, sizeof(buffer)) > 0)
+                ;
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        ssize_t n = read(client.fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            // The client is done sending; stay until its answers are out.
+            std::lock_guard<std::mutex> lock(client.mutex);
+            client.reading = false;
+            continue;
+        }
+        inbox.insert(inbox.end(), buffer, buffer + n);
+        size_t used = 0;
+        for (; inbox.size() - used >= sizeof(Request); used += sizeof(Request))
+        {
+            Request request;
+            std::memcpy(&request, inbox.data() + used, sizeof(request));
+            if (!HandleRequest(connection, request, queue, stats, rows, cols))
+                return;
+        }
+        inbox.erase(inbox.begin(), inbox.begin() + used);
+    }
+}
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void OnSignal(int) { stop_requested = 1; }
+
+#include "test.cpp"
+
+/**
+ * Usage: server [board | random:<side>] [socket] [workers] [max batch] [batch window us]
+ * Build: g++ -std=c++17 -O2 -pthread server.cpp planner.cpp -o server
+ */
+int main(int argc, char *argv[])
+{
+    string board_spec = argc > 1 ? argv[1] : "../files/1.board";
+    string socket_path = argc > 2 ? argv[2] : "/tmp/path_server.sock";
+    int n_workers = argc > 3 ? std::atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    size_t max_batch = argc > 4 ? std::atoi(argv[4]) : 32;
+    auto window = std::chrono::microseconds(argc > 5 ? std::atoi(argv[5]) : 0);
+
+    // Tests
+    TestPlannerSearch();
+    TestLoadBoard();
+    TestProtocol();
+    TestHandleRequest();
+
+    auto grid = LoadBoard(board_spec);
+    if (grid.empty() || grid[0].empty())
+    {
+        std::cerr << "Could not load board " << board_spec << "\n";
+        return EXIT_FAILURE;
+    }
+
+    // No SA_RESTART, so Ctrl-C interrupts accept() and the loop below ends.
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = OnSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (listener < 0 || socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Cannot create socket " << socket_path << "\n";
+        return EXIT_FAILURE;
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listener, 128) < 0)
+    {
+        std::perror("bind");
+        return EXIT_FAILURE;
+    }
+
+    BatchQueue queue;
+    ServerStats stats;
+    vector<std::thread> workers;
+    for (int i = 0; i < n_workers; i++)
+        workers.emplace_back(Worker, std::ref(queue), std::cref(grid), std::ref(stats), max_batch, window);
+    cout << "Serving a " << grid.size() << "x" << grid[0].size() << " board on " << socket_path << " with "
+         << n_workers << " workers\n";
+
+    while (!stop_requested)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::perror("accept");
+            break;
+        }
+        std::thread(ServeConnection, std::make_shared<Connection>(fd), std::ref(queue), std::cref(stats),
+                    static_cast<int>(grid.size()), static_cast<int>(grid[0].size()))
+            .detach();
+    }
+
+    close(listener);
+    unlink(socket_path.c_str());
+    queue.Close();
+    for (auto &worker : workers)
+        worker.join();
+    cout << FormatStats(stats) << std::flush;
+    // Connection threads are detached and may still be blocked in poll(),
+    // so leave without tearing down the state they point to.
+    _exit(EXIT_SUCCESS);
+}
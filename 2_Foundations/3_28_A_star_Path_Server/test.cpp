@@ -0,0 +1,295 @@
+/**
+ * Read one response from `fd`: the header and its payload of int16 values.
+ */
+bool ReadResponse(int fd, ResponseHeader &header, vector<int16_t> &payload)
+{
+    if (!ReadAll(fd, &header, sizeof(header)))
+        return false;
+    payload.resize(header.length / sizeof(int16_t));
+    return ReadAll(fd, payload.data(), header.length);
+}
+
+/**
+ * True if `path` holds x, y pairs of free cells from init to goal, one step apart.
+ */
+bool CheckPath(const vector<vector<State>> &grid, const vector<int16_t> &path, int init[2], int goal[2])
+{
+    int n = path.size();
+    if (n < 2 || n % 2 != 0 || path[0] != init[0] || path[1] != init[1] || path[n - 2] != goal[0] ||
+        path[n - 1] != goal[1])
+        return false;
+    for (int i = 0; i < n; i += 2)
+    {
+        if (grid[path[i]][path[i + 1]] == State::kObstacle)
+            return false;
+        if (i > 0 && std::abs(path[i] - path[i - 2]) + std::abs(path[i + 1] - path[i - 1]) != 1)
+            return false;
+    }
+    return true;
+}
+
+void TestPlannerSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Planner Search Test: ";
+    auto grid = LoadBoard("../files/1.board");
+    Planner planner(grid);
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    int blocked[2]{0, 1};
+    vector<int16_t> path;
+
+    int cost = planner.Search(init, goal, path);
+    bool valid = CheckPath(grid, path, init, goal);
+    int to_blocked = planner.Search(init, blocked, path);
+    bool cleared = path.empty();
+    // The scratch arrays are reused, so a second search must not see the first.
+    int again = planner.Search(init, goal, path);
+
+    if (cost != 11 || again != 11)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Search on 1.board returned " << cost << " and " << again << ", expected 11"
+             << "\n";
+        cout << "\n";
+    }
+    else if (!valid || path.size() != 24)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The path must be 12 adjacent free cells from (0, 0) to (4, 5)."
+             << "\n";
+        cout << "\n";
+    }
+    else if (to_blocked != -1 || !cleared)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "A search to an obstacle returned " << to_blocked << ", expected -1 and no path"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestLoadBoard()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "LoadBoard Function Test: ";
+    auto random = LoadBoard("random:12");
+    bool square = random.size() == 12 && random[0].size() == 12;
+    bool same = LoadBoard("random:12") == random;
+    // Keep the messages that explain each rejection out of the test output.
+    std::streambuf *errors = std::cerr.rdbuf(nullptr);
+    bool rejected = true;
+    for (string spec : {"random:-5", "random:0", "random:32768", "random:abc", "random:12x"})
+        rejected = rejected && LoadBoard(spec).empty();
+    std::cerr.rdbuf(errors);
+    std::cerr.clear();
+
+    if (!square || !same)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "random:12 must build the same 12x12 board every time."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!rejected)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Sides below 1, above " << kMaxSide << " or not a number must give an empty board."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestProtocol()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Protocol Encoding Test: ";
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    {
+        cout << "failed"
+             << "\n";
+        return;
+    }
+    Request request{};
+    request.id = 0xdeadbeef;
+    request.type = kPathQuery;
+    request.init[0] = -1;
+    request.init[1] = 32767;
+    request.goal[0] = 4;
+    request.goal[1] = -32768;
+    ResponseHeader header{7, kOffBoard, 4};
+    vector<int16_t> payload{3, -3};
+
+    Request decoded{};
+    ResponseHeader decoded_header{};
+    vector<int16_t> decoded_payload;
+    bool sent = WriteAll(fds[0], &request, sizeof(request)) && WriteAll(fds[0], &header, sizeof(header)) &&
+                WriteAll(fds[0], payload.data(), header.length);
+    bool received = ReadAll(fds[1], &decoded, sizeof(decoded)) && ReadResponse(fds[1], decoded_header, decoded_payload);
+    bool request_ok = decoded.id == request.id && decoded.type == request.type &&
+                      std::equal(request.init, request.init + 2, decoded.init) &&
+                      std::equal(request.goal, request.goal + 2, decoded.goal);
+    bool header_ok = decoded_header.id == header.id && decoded_header.cost == header.cost &&
+                     decoded_header.length == header.length && decoded_payload == payload;
+    bool layout_ok = offsetof(Request, type) == 4 && offsetof(Request, init) == 8 && offsetof(Request, goal) == 12 &&
+                     offsetof(ResponseHeader, cost) == 4 && offsetof(ResponseHeader, length) == 8;
+
+    // A message cut short by the peer hanging up must not decode.
+    WriteAll(fds[0], &request, sizeof(request) / 2);
+    close(fds[0]);
+    bool truncated = !ReadAll(fds[1], &decoded, sizeof(decoded));
+    close(fds[1]);
+
+    if (!sent || !received || !request_ok || !header_ok)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "A Request and a ResponseHeader with payload must decode to what was encoded."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!layout_ok)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The field offsets of Request or ResponseHeader moved."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!truncated)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "ReadAll must fail on a message cut short by the peer."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestHandleRequest()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "HandleRequest Function Test: ";
+    auto grid = LoadBoard("../files/1.board");
+    int rows = grid.size();
+    int cols = grid[0].size();
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    {
+        cout << "failed"
+             << "\n";
+        return;
+    }
+    auto connection = std::make_shared<Connection>(fds[0]);
+    BatchQueue queue;
+    ServerStats stats;
+    std::thread worker(Worker, std::ref(queue), std::cref(grid), std::ref(stats), 8, Clock::duration::zero());
+
+    struct Case
+    {
+        uint32_t id;
+        int16_t init[2];
+        int16_t goal[2];
+        int32_t cost;
+    };
+    vector<Case> cases{
+        {1, {0, 0}, {4, 5}, 11},       {2, {-1, 0}, {4, 5}, kOffBoard}, {3, {0, 0}, {5, 0}, kOffBoard},
+        {4, {0, 0}, {0, 6}, kOffBoard}, {5, {0, 0}, {0, 1}, -1},         {6, {4, 4}, {0, 0}, -1},
+    };
+    bool handled = true;
+    for (const auto &c : cases)
+    {
+        Request request{c.id, kPathQuery, {}, {c.init[0], c.init[1]}, {c.goal[0], c.goal[1]}};
+        handled = handled && HandleRequest(connection, request, queue, stats, rows, cols);
+    }
+
+    // Answers can arrive out of order, so match them by id.
+    string failure;
+    for (size_t i = 0; i < cases.size() && failure.empty(); i++)
+    {
+        ResponseHeader header;
+        vector<int16_t> path;
+        if (!ReadResponse(fds[1], header, path))
+        {
+            failure = "the connection closed after " + std::to_string(i) + " responses";
+            break;
+        }
+        auto c = std::find_if(cases.begin(), cases.end(), [&](const Case &c) { return c.id == header.id; });
+        if (c == cases.end())
+        {
+            failure = "unknown response id " + std::to_string(header.id);
+            continue;
+        }
+        int init[2]{c->init[0], c->init[1]};
+        int goal[2]{c->goal[0], c->goal[1]};
+        bool path_ok = c->cost >= 0 ? CheckPath(grid, path, init, goal) : path.empty();
+        if (header.cost != c->cost || !path_ok)
+            failure = "query " + std::to_string(c->id) + " got cost " + std::to_string(header.cost) + ", expected " +
+                      std::to_string(c->cost);
+    }
+    queue.Close();
+    worker.join();
+    close(fds[1]);
+
+    if (!handled)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "HandleRequest must keep the client for every path query."
+             << "\n";
+        cout << "\n";
+    }
+    else if (!failure.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << failure << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
@@ -0,0 +1,529 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+// Side of the square tiles a board version is split into
+const int kTileSide = 32;
+
+struct Tile
+{
+    State cells[kTileSide * kTileSide];
+};
+
+/**
+ * One immutable version of the board. Tiles that did not change between
+ * versions are shared, so publishing an update copies only the tiles it
+ * touches.
+ */
+struct BoardVersion
+{
+    int rows;
+    int cols;
+    int tile_cols;
+    long number;
+    vector<std::shared_ptr<const Tile>> tiles;
+
+    State At(int x, int y) const
+    {
+        const Tile &tile = *tiles[(x / kTileSide) * tile_cols + y / kTileSide];
+        return tile.cells[(x % kTileSide) * kTileSide + y % kTileSide];
+    }
+};
+
+/**
+ * Check that a cell is valid: on the grid and not an obstacle.
+ */
+bool CheckValidCell(int x, int y, const BoardVersion &board)
+{
+    bool on_grid_x = (x >= 0 && x < board.rows);
+    bool on_grid_y = (y >= 0 && y < board.cols);
+    if (on_grid_x && on_grid_y)
+        return board.At(x, y) != State::kObstacle;
+    return false;
+}
+
+struct ObstacleUpdate
+{
+    int x;
+    int y;
+    bool obstacle;
+};
+
+/**
+ * A board that is updated while queries run. Writers build a new version and
+ * publish it with one atomic pointer swap; readers pin the version they
+ * loaded by announcing the current epoch in their own slot, RCU style, so
+ * they never take a lock. A replaced version is freed once every reader has
+ * either left or announced a later epoch.
+ */
+class VersionedBoard
+{
+  public:
+    static const int kMaxReaders = 64;
+
+    VersionedBoard(const vector<vector<State>> &grid)
+    {
+        auto *version = new BoardVersion{int(grid.size()), int(grid[0].size()), 0, 0, {}};
+        version->tile_cols = (version->cols + kTileSide - 1) / kTileSide;
+        int tile_rows = (version->rows + kTileSide - 1) / kTileSide;
+        for (int tx = 0; tx < tile_rows; tx++)
+        {
+            for (int ty = 0; ty < version->tile_cols; ty++)
+            {
+                // Cells past the edge of the board are never read.
+                auto tile = std::make_shared<Tile>();
+                for (int i = 0; i < kTileSide * kTileSide; i++)
+                {
+                    int x = tx * kTileSide + i / kTileSide;
+                    int y = ty * kTileSide + i % kTileSide;
+                    tile->cells[i] = x < version->rows && y < version->cols ? grid[x][y] : State::kObstacle;
+                }
+                version->tiles.push_back(std::move(tile));
+            }
+        }
+        current.store(version);
+    }
+
+    ~VersionedBoard()
+    {
+        for (auto &retiree : retired)
+            delete retiree.version;
+        delete current.load();
+    }
+
+    /**
+     * Claim a reader slot. Each reading thread needs its own. Returns -1 if
+     * all kMaxReaders slots are taken.
+     */
+    int RegisterReader()
+    {
+        for (int i = 0; i < kMaxReaders; i++)
+        {
+            bool expected = false;
+            if (!slots[i].claimed.load(std::memory_order_relaxed) &&
+                slots[i].claimed.compare_exchange_strong(expected, true))
+                return i;
+        }
+        return -1;
+    }
+
+    // Give a slot back for another thread to claim. Call it outside BeginRead/EndRead.
+    void UnregisterReader(int reader)
+    {
+        slots[reader].epoch.store(0, std::memory_order_release);
+        slots[reader].claimed.store(false, std::memory_order_release);
+    }
+
+    /**
+     * Pin and return the current version. It stays valid and unchanged
+     * until EndRead on the same slot.
+     */
+    const BoardVersion &BeginRead(int reader)
+    {
+        slots[reader].epoch.store(epoch.load());
+        return *current.load();
+    }
+
+    void EndRead(int reader) { slots[reader].epoch.store(0, std::memory_order_release); }
+
+    /**
+     * Publish a new version with `updates` applied. Only the tiles that
+     * contain an updated cell are copied; the rest are shared with the
+     * previous version. Writers are serialized with a mutex.
+     */
+    void Apply(const vector<ObstacleUpdate> &updates)
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        const BoardVersion *old = current.load();
+        auto *next = new BoardVersion(*old);
+        next->number++;
+        vector<Tile *> copied(next->tiles.size(), nullptr);
+        for (const auto &update : updates)
+        {
+            int t = (update.x / kTileSide) * next->tile_cols + update.y / kTileSide;
+            if (!copied[t])
+            {
+                auto tile = std::make_shared<Tile>(*next->tiles[t]);
+                copied[t] = tile.get();
+                next->tiles[t] = std::move(tile);
+            }
+            copied[t]->cells[(update.x % kTileSide) * kTileSide + update.y % kTileSide] =
+                update.obstacle ? State::kObstacle : State::kEmpty;
+        }
+
+        current.store(next);
+        // Readers announcing this epoch or later can only have loaded `next`.
+        retired.push_back(Retiree{old, epoch.fetch_add(1) + 1});
+        Reclaim();
+    }
+
+    // Versions replaced but still pinned by some reader
+    int RetiredCount()
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        return retired.size();
+    }
+
+  private:
+    struct Retiree
+    {
+        const BoardVersion *version;
+        long safe_epoch;
+    };
+
+    // One cache line per reader, so announcing an epoch does not bounce
+    // other readers' lines.
+    struct alignas(64) Slot
+    {
+        std::atomic<long> epoch{0}; // 0 while the reader is outside BeginRead/EndRead
+        std::atomic<bool> claimed{false};
+    };
+
+    void Reclaim()
+    {
+        long oldest = epoch.load();
+        for (int i = 0; i < kMaxReaders; i++)
+        {
+            long e = slots[i].epoch.load();
+            if (e != 0)
+                oldest = std::min(oldest, e);
+        }
+        auto safe = std::partition(retired.begin(), retired.end(),
+                                   [oldest](const Retiree &r) { return r.safe_epoch > oldest; });
+        for (auto it = safe; it != retired.end(); ++it)
+            delete it->version;
+        retired.erase(safe, retired.end());
+    }
+
+    std::atomic<const BoardVersion *> current{nullptr};
+    std::atomic<long> epoch{1};
+    Slot slots[kMaxReaders];
+    std::mutex writer;
+    vector<Retiree> retired;
+};
+
+/**
+ * Pins the current version of a VersionedBoard for as long as it lives.
+ */
+class Snapshot
+{
+  public:
+    Snapshot(VersionedBoard &board, int reader) : board(board), reader(reader), version(board.BeginRead(reader)) {}
+    ~Snapshot() { board.EndRead(reader); }
+    const BoardVersion &operator*() const { return version; }
+    const BoardVersion *operator->() const { return &version; }
+
+  private:
+    VersionedBoard &board;
+    int reader;
+    const BoardVersion &version;
+};
+
+/**
+ * Implementation of A* search algorithm on one board version. Returns the
+ * path cost, or -1 if there is none, and fills `path` from init to goal.
+ */
+int Search(const BoardVersion &board, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    path.clear();
+    if (!CheckValidCell(init[0], init[1], board) || !CheckValidCell(goal[0], goal[1], board))
+        return -1;
+    int cols = board.cols;
+    vector<int> g(board.rows * cols, -1);
+    vector<int> parent(board.rows * cols, -1);
+    // (f, -g, cell) so ties go to the deeper node
+    std::priority_queue<std::tuple<int, int, int>, vector<std::tuple<int, int, int>>,
+                        std::greater<std::tuple<int, int, int>>>
+        open;
+    int start = init[0] * cols + init[1];
+    int target = goal[0] * cols + goal[1];
+    g[start] = 0;
+    parent[start] = start;
+    open.push({Heuristic(init[0], init[1], goal[0], goal[1]), 0, start});
+
+    while (!open.empty())
+    {
+        auto [f, neg_g, cell] = open.top();
+        open.pop();
+        if (-neg_g != g[cell])
+            continue;
+        if (cell == target)
+            break;
+        int x = cell / cols;
+        int y = cell % cols;
+        for (auto d : delta)
+        {
+            int x2 = x + d[0];
+            int y2 = y + d[1];
+            if (!CheckValidCell(x2, y2, board))
+                continue;
+            int next = x2 * cols + y2;
+            if (g[next] >= 0 && g[next] <= g[cell] + 1)
+                continue;
+            g[next] = g[cell] + 1;
+            parent[next] = cell;
+            open.push({g[next] + Heuristic(x2, y2, goal[0], goal[1]), -g[next], next});
+        }
+    }
+
+    if (g[target] < 0)
+        return -1;
+    for (int cell = target;; cell = parent[cell])
+    {
+        path.push_back(vector<int>{cell / cols, cell % cols});
+        if (parent[cell] == cell)
+            break;
+    }
+    std::reverse(path.begin(), path.end());
+    return g[target];
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Copy a board version out as a grid with the path drawn on it.
+ */
+vector<vector<State>> DrawPath(const BoardVersion &board, const vector<vector<int>> &path)
+{
+    vector<vector<State>> grid(board.rows, vector<State>(board.cols));
+    for (int x = 0; x < board.rows; x++)
+        for (int y = 0; y < board.cols; y++)
+            grid[x][y] = board.At(x, y);
+    for (const auto &p : path)
+        grid[p[0]][p[1]] = State::kPath;
+    if (!path.empty())
+    {
+        grid[path.front()[0]][path.front()[1]] = State::kStart;
+        grid[path.back()[0]][path.back()[1]] = State::kFinish;
+    }
+    return grid;
+}
+
+/**
+ * Query latency percentiles from the reader threads and the update rate the
+ * writer achieved in one run.
+ */
+struct ContentionResult
+{
+    double updates_per_second;
+    double p50_us;
+    double p99_us;
+    long queries;
+};
+
+/**
+ * Run `n_readers` threads of short random queries for `duration` while one
+ * writer sets random cells at up to `target_rate` updates per second.
+ */
+ContentionResult RunContention(const vector<vector<State>> &grid, int n_readers, double target_rate,
+                               std::chrono::milliseconds duration)
+{
+    using Clock = std::chrono::steady_clock;
+    VersionedBoard board(grid);
+    std::atomic<bool> stop{false};
+    int side = grid.size();
+
+    vector<vector<double>> latencies(n_readers);
+    auto reader = [&](int r) {
+        int slot = board.RegisterReader();
+        std::mt19937 rng(r + 1);
+        std::uniform_int_distribution<int> pos(0, side - 1);
+        std::uniform_int_distribution<int> offset(-16, 16);
+        vector<vector<int>> path;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            int init[2]{pos(rng), pos(rng)};
+            int goal[2]{std::clamp(init[0] + offset(rng), 0, side - 1), std::clamp(init[1] + offset(rng), 0, side - 1)};
+            auto t1 = Clock::now();
+            {
+                Snapshot snapshot(board, slot);
+                Search(*snapshot, init, goal, path);
+            }
+            latencies[r].push_back(std::chrono::duration<double, std::micro>(Clock::now() - t1).count());
+        }
+        board.UnregisterReader(slot);
+    };
+
+    long updates = 0;
+    auto writer = [&]() {
+        std::mt19937 rng(99);
+        std::uniform_int_distribution<int> pos(0, side - 1);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        auto start = Clock::now();
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (updates >= target_rate * elapsed)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            board.Apply({ObstacleUpdate{pos(rng), pos(rng), coin(rng) < 0.2}});
+            updates++;
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int r = 0; r < n_readers; r++)
+        threads.emplace_back(reader, r);
+    if (target_rate > 0)
+        threads.emplace_back(writer);
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &t : threads)
+        t.join();
+
+    vector<double> all;
+    for (auto &l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    double seconds = std::chrono::duration<double>(duration).count();
+    if (all.empty())
+        return ContentionResult{updates / seconds, 0, 0, 0};
+    return ContentionResult{updates / seconds, all[all.size() / 2], all[all.size() * 99 / 100], long(all.size())};
+}
+
+/**
+ * Sweep the update rate and report what it does to query latency.
+ */
+void BenchmarkContention()
+{
+    cout << "==========================================================\n";
+    cout << "Updates against queries on a 256x256 board, 4 readers\n";
+    int side = 256;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> board(side, vector<State>(side, State::kEmpty));
+    for (auto &row : board)
+        for (auto &cell : row)
+            if (coin(rng) < 0.2)
+                cell = State::kObstacle;
+
+    for (double rate : {0.0, 1e3, 1e4, 1e5})
+    {
+        auto result = RunContention(board, 4, rate, std::chrono::milliseconds(300));
+        cout << "target " << rate << " updates/s: achieved " << result.updates_per_second << " updates/s, p50 "
+             << result.p50_us << " us, p99 " << result.p99_us << " us (" << result.queries << " queries)\n";
+    }
+}
+
+#include "test.cpp"
+
+int main()
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    VersionedBoard board(ReadBoardFile("../files/1.board"));
+    int reader = board.RegisterReader();
+    vector<vector<int>> path;
+    {
+        Snapshot snapshot(board, reader);
+        Search(*snapshot, init, goal, path);
+        PrintBoard(DrawPath(*snapshot, path));
+    }
+    // Tests
+    TestCopyOnWrite();
+    TestSnapshotSearch();
+    TestReclaim();
+    TestReaderSlots();
+    BenchmarkContention();
+}
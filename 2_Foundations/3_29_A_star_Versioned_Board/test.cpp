@@ -0,0 +1,169 @@
+void TestCopyOnWrite()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Copy-on-Write Test: ";
+    vector<vector<State>> grid(100, vector<State>(100, State::kEmpty));
+    VersionedBoard board(grid);
+    int reader = board.RegisterReader();
+    const BoardVersion &before = board.BeginRead(reader);
+    board.Apply({ObstacleUpdate{40, 70, true}, ObstacleUpdate{41, 71, true}});
+    const BoardVersion &after = board.BeginRead(board.RegisterReader());
+
+    int shared = 0;
+    for (int t = 0; t < before.tiles.size(); t++)
+        shared += before.tiles[t] == after.tiles[t];
+
+    if (before.At(40, 70) != State::kEmpty || after.At(40, 70) != State::kObstacle ||
+        after.At(41, 71) != State::kObstacle || after.number != before.number + 1)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "The old snapshot must keep its cells and the new version must see the update."
+             << "\n";
+        cout << "\n";
+    }
+    else if (shared != before.tiles.size() - 1)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Only the updated tile should be copied, " << shared << " of " << before.tiles.size()
+             << " tiles are shared."
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    board.EndRead(reader);
+    return;
+}
+
+void TestSnapshotSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Snapshot Search Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    VersionedBoard board(ReadBoardFile("../files/1.board"));
+    int reader = board.RegisterReader();
+    vector<vector<int>> path;
+
+    Snapshot old_snapshot(board, reader);
+    int before = Search(*old_snapshot, init, goal, path);
+    // Close the only gap in the wall of obstacles.
+    board.Apply({ObstacleUpdate{4, 1, true}});
+    int pinned = Search(*old_snapshot, init, goal, path);
+    Snapshot new_snapshot(board, board.RegisterReader());
+    int after = Search(*new_snapshot, init, goal, path);
+
+    if (before != 11 || pinned != 11)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Search on the pinned snapshot returned " << before << " and " << pinned << ", expected 11"
+             << "\n";
+        cout << "\n";
+    }
+    else if (after != -1)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Search on the updated board returned " << after << ", expected no path"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestReclaim()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Version Reclaim Test: ";
+    vector<vector<State>> grid(64, vector<State>(64, State::kEmpty));
+    VersionedBoard board(grid);
+    int reader = board.RegisterReader();
+
+    board.BeginRead(reader);
+    for (int i = 0; i < 3; i++)
+        board.Apply({ObstacleUpdate{i, i, true}});
+    int pinned = board.RetiredCount();
+    board.EndRead(reader);
+    board.Apply({ObstacleUpdate{10, 10, true}});
+    int released = board.RetiredCount();
+
+    if (pinned != 3 || released != 0)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Retired versions: " << pinned << " while a reader is pinned (expected 3), " << released
+             << " after it left (expected 0)"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestReaderSlots()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Reader Slots Test: ";
+    vector<vector<State>> grid(8, vector<State>(8, State::kEmpty));
+    VersionedBoard board(grid);
+    vector<int> readers;
+    for (int i = 0; i < VersionedBoard::kMaxReaders; i++)
+        readers.push_back(board.RegisterReader());
+    int overflow = board.RegisterReader();
+    board.UnregisterReader(readers[10]);
+    int reused = board.RegisterReader();
+
+    std::sort(readers.begin(), readers.end());
+    bool distinct = std::adjacent_find(readers.begin(), readers.end()) == readers.end() && readers.front() == 0 &&
+                    readers.back() == VersionedBoard::kMaxReaders - 1;
+    if (!distinct || overflow != -1)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Expected " << VersionedBoard::kMaxReaders << " distinct slots and then -1, got " << overflow
+             << "\n";
+        cout << "\n";
+    }
+    else if (reused != readers[10])
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "A released slot should be claimed again, got " << reused << " instead of " << readers[10]
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
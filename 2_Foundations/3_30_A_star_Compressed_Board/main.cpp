@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+using std::abs;
+using std::cout;
+using std::ifstream;
+using std::istringstream;
+using std::string;
+using std::vector;
+
+enum class State
+{
+    kEmpty,
+    kObstacle,
+    kClosed,
+    kPath,
+    kStart,
+    kFinish
+};
+
+// directional deltas
+const int delta[4][2]{{-1, 0}, {0, -1}, {1, 0}, {0, 1}};
+
+vector<State> ParseLine(string line)
+{
+    istringstream sline(line);
+    int n;
+    char c;
+    vector<State> row;
+    while (sline >> n >> c && c == ',')
+    {
+        if (n == 0)
+        {
+            row.push_back(State::kEmpty);
+        }
+        else
+        {
+            row.push_back(State::kObstacle);
+        }
+    }
+    return row;
+}
+
+vector<vector<State>> ReadBoardFile(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    if (myfile)
+    {
+        string line;
+        while (getline(myfile, line))
+        {
+            vector<State> row = ParseLine(line);
+            board.push_back(row);
+        }
+    }
+    return board;
+}
+
+/**
+ * Read a map in the Moving AI benchmark format: a four line header, then
+ * one character per cell. '.', 'G' and 'S' are passable, anything else is
+ * an obstacle.
+ */
+vector<vector<State>> ReadMovingAiMap(string path)
+{
+    ifstream myfile(path);
+    vector<vector<State>> board{};
+    string line;
+    while (getline(myfile, line) && line != "map")
+    {
+    }
+    while (getline(myfile, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+        vector<State> row;
+        for (char c : line)
+            row.push_back(c == '.' || c == 'G' || c == 'S' ? State::kEmpty : State::kObstacle);
+        board.push_back(row);
+    }
+    return board;
+}
+
+vector<vector<State>> ReadBoard(string path)
+{
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".map") == 0)
+        return ReadMovingAiMap(path);
+    return ReadBoardFile(path);
+}
+
+// Calculate the manhattan distance
+int Heuristic(int x1, int y1, int x2, int y2)
+{
+    return abs(x2 - x1) + abs(y2 - y1);
+}
+
+/**
+ * Bytes held by the uncompressed board, including each row's vector.
+ */
+size_t GridBytes(const vector<vector<State>> &grid)
+{
+    size_t bytes = sizeof(grid);
+    for (const auto &row : grid)
+        bytes += sizeof(row) + row.capacity() * sizeof(State);
+    return bytes;
+}
+
+/**
+ * Board with one bit per cell, 1 for an obstacle, packed 64 cells to a word.
+ * Every row starts on a fresh word.
+ */
+class PackedBoard
+{
+  public:
+    PackedBoard(const vector<vector<State>> &grid)
+        : rows(grid.size()), cols(grid.empty() ? 0 : grid[0].size()), words_per_row((cols + 63) / 64),
+          bits(rows * words_per_row, 0)
+    {
+        for (int x = 0; x < rows; x++)
+            for (int y = 0; y < cols; y++)
+                if (grid[x][y] == State::kObstacle)
+                    bits[x * words_per_row + y / 64] |= uint64_t{1} << (y % 64);
+    }
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+
+    bool IsObstacle(int x, int y) const { return (bits[x * words_per_row + y / 64] >> (y % 64)) & 1; }
+
+    // First obstacle in row x at column y or later, Cols() if there is none
+    int NextObstacle(int x, int y) const
+    {
+        if (y >= cols)
+            return cols;
+        const uint64_t *row = &bits[x * words_per_row];
+        int w = y / 64;
+        uint64_t word = row[w] & (~uint64_t{0} << (y % 64));
+        while (word == 0)
+        {
+            if (++w == words_per_row)
+                return cols;
+            word = row[w];
+        }
+        return w * 64 + __builtin_ctzll(word);
+    }
+
+    size_t MemoryBytes() const
+    {
+        return sizeof(*this) + bits.capacity() * sizeof(uint64_t);
+    }
+
+  private:
+    int rows;
+    int cols;
+    int words_per_row;
+    vector<uint64_t> bits;
+};
+
+/**
+ * Run-length encoded board. Each row is stored as the sorted columns where
+ * the state flips, starting from kEmpty at column 0, so a row of one long
+ * run costs nothing and a cell lookup is a binary search.
+ */
+class RleBoard
+{
+  public:
+    RleBoard(const vector<vector<State>> &grid)
+        : rows(grid.size()), cols(grid.empty() ? 0 : grid[0].size()), row_start(rows + 1, 0)
+    {
+        for (int x = 0; x < rows; x++)
+        {
+            bool obstacle = false;
+            for (int y = 0; y < cols; y++)
+            {
+                if ((grid[x][y] == State::kObstacle) != obstacle)
+                {
+                    obstacle = !obstacle;
+                    flips.push_back(y);
+                }
+            }
+            row_start[x + 1] = flips.size();
+        }
+        flips.shrink_to_fit();
+    }
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+
+    // Number of runs in row x
+    int Runs(int x) const { return row_start[x + 1] - row_start[x] + 1; }
+
+    bool IsObstacle(int x, int y) const
+    {
+        auto begin = flips.begin() + row_start[x];
+        auto end = flips.begin() + row_start[x + 1];
+        // An odd number of flips at or before y means y is inside an obstacle run.
+        return (std::upper_bound(begin, end, y) - begin) & 1;
+    }
+
+    // First obstacle in row x at column y or later, Cols() if there is none
+    int NextObstacle(int x, int y) const
+    {
+        if (y >= cols)
+            return cols;
+        auto begin = flips.begin() + row_start[x];
+        auto end = flips.begin() + row_start[x + 1];
+        auto next = std::upper_bound(begin, end, y);
+        if ((next - begin) & 1)
+            return y;
+        return next == end ? cols : *next;
+    }
+
+    size_t MemoryBytes() const
+    {
+        return sizeof(*this) + flips.capacity() * sizeof(int) + row_start.capacity() * sizeof(int);
+    }
+
+  private:
+    int rows;
+    int cols;
+    vector<int> flips;
+    vector<int> row_start; // flips of row x are flips[row_start[x] .. row_start[x + 1])
+};
+
+/**
+ * Check that a cell is valid: on the grid and not an obstacle. Works on the
+ * compressed boards without expanding them.
+ */
+template <typename Board>
+bool CheckValidCell(int x, int y, const Board &board)
+{
+    bool on_grid_x = (x >= 0 && x < board.Rows());
+    bool on_grid_y = (y >= 0 && y < board.Cols());
+    if (on_grid_x && on_grid_y)
+        return !board.IsObstacle(x, y);
+    return false;
+}
+
+/**
+ * Implementation of A* search algorithm on a compressed board. Returns the
+ * path cost, or -1 if there is none, and fills `path` from init to goal.
+ */
+template <typename Board>
+int Search(const Board &board, int init[2], int goal[2], vector<vector<int>> &path)
+{
+    path.clear();
+    if (!CheckValidCell(init[0], init[1], board) || !CheckValidCell(goal[0], goal[1], board))
+        return -1;
+    int cols = board.Cols();
+    vector<int> g(board.Rows() * cols, -1);
+    vector<int> parent(board.Rows() * cols, -1);
+    // (f, -g, cell) so ties go to the deeper node
+    std::priority_queue<std::tuple<int, int, int>, vector<std::tuple<int, int, int>>,
+                        std::greater<std::tuple<int, int, int>>>
+        open;
+    int start = init[0] * cols + init[1];
+    int target = goal[0] * cols + goal[1];
+    g[start] = 0;
+    parent[start] = start;
+    open.push({Heuristic(init[0], init[1], goal[0], goal[1]), 0, start});
+
+    while (!open.empty())
+    {
+        auto [f, neg_g, cell] = open.top();
+        open.pop();
+        if (-neg_g != g[cell])
+            continue;
+        if (cell == target)
+            break;
+        int x = cell / cols;
+        int y = cell % cols;
+        for (auto d : delta)
+        {
+            int x2 = x + d[0];
+            int y2 = y + d[1];
+            if (!CheckValidCell(x2, y2, board))
+                continue;
+            int next = x2 * cols + y2;
+            if (g[next] >= 0 && g[next] <= g[cell] + 1)
+                continue;
+            g[next] = g[cell] + 1;
+            parent[next] = cell;
+            open.push({g[next] + Heuristic(x2, y2, goal[0], goal[1]), -g[next], next});
+        }
+    }
+
+    if (g[target] < 0)
+        return -1;
+    for (int cell = target;; cell = parent[cell])
+    {
+        path.push_back(vector<int>{cell / cols, cell % cols});
+        if (parent[cell] == cell)
+            break;
+    }
+    std::reverse(path.begin(), path.end());
+    return g[target];
+}
+
+string CellString(State cell)
+{
+    switch (cell)
+    {
+    case State::kObstacle:
+        return "⛰️   ";
+    case State::kPath:
+        return "🚗   ";
+    case State::kStart:
+        return "🚦   ";
+    case State::kFinish:
+        return "🏁   ";
+    default:
+        return "0   ";
+    }
+}
+
+void PrintBoard(const vector<vector<State>> board)
+{
+    for (int i = 0; i < board.size(); i++)
+    {
+        for (int j = 0; j < board[i].size(); j++)
+        {
+            cout << CellString(board[i][j]);
+        }
+        cout << "\n";
+    }
+}
+
+/**
+ * Build a square board with randomly placed obstacles.
+ */
+vector<vector<State>> RandomBoard(int side, double density, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (auto &row : grid)
+        for (auto &cell : row)
+            if (coin(rng) < density)
+                cell = State::kObstacle;
+    return grid;
+}
+
+/**
+ * Build an indoor-style board: square rooms separated by one-cell walls,
+ * with a door in the middle of every wall segment.
+ */
+vector<vector<State>> RoomsBoard(int side, int room)
+{
+    vector<vector<State>> grid(side, vector<State>(side, State::kEmpty));
+    for (int x = 0; x < side; x++)
+    {
+        for (int y = 0; y < side; y++)
+        {
+            bool wall = x % room == 0 || y % room == 0;
+            bool door = (x % room == 0 && y % room == room / 2) || (y % room == 0 && x % room == room / 2);
+            if (wall && !door)
+                grid[x][y] = State::kObstacle;
+        }
+    }
+    return grid;
+}
+
+/**
+ * Print the size of each representation of `grid` and the cost of a million
+ * random cell lookups and row scans on each.
+ */
+void ReportBoard(const string &name, const vector<vector<State>> &grid)
+{
+    PackedBoard packed(grid);
+    RleBoard rle(grid);
+    int rows = grid.size();
+    int cols = grid[0].size();
+    long runs = 0;
+    for (int x = 0; x < rows; x++)
+        runs += rle.Runs(x);
+
+    size_t grid_bytes = GridBytes(grid);
+    cout << name << " (" << rows << "x" << cols << ", " << double(runs) / rows << " runs/row)\n";
+    cout << "  vector<vector<State>>: " << grid_bytes << " bytes\n";
+    cout << "  PackedBoard: " << packed.MemoryBytes() << " bytes (" << double(grid_bytes) / packed.MemoryBytes()
+         << "x smaller)\n";
+    cout << "  RleBoard: " << rle.MemoryBytes() << " bytes (" << double(grid_bytes) / rle.MemoryBytes()
+         << "x smaller)\n";
+
+    std::mt19937 rng(1);
+    vector<int> xs(1000000), ys(1000000);
+    for (int i = 0; i < xs.size(); i++)
+    {
+        xs[i] = rng() % rows;
+        ys[i] = rng() % cols;
+    }
+    // Every board must give the same sum of answers, which also keeps the
+    // compiler from dropping the timed loops.
+    long expected = 0;
+    bool agree = true;
+    auto time_ns = [&](auto lookup) {
+        long sum = 0;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < xs.size(); i++)
+            sum += lookup(xs[i], ys[i]);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        agree = agree && sum == expected;
+        return std::chrono::duration<double, std::nano>(t2 - t1).count() / xs.size();
+    };
+
+    expected = 0;
+    for (int i = 0; i < xs.size(); i++)
+        expected += grid[xs[i]][ys[i]] != State::kObstacle;
+    cout << "  CheckValidCell ns: grid " << time_ns([&](int x, int y) { return grid[x][y] != State::kObstacle; })
+         << ", packed " << time_ns([&](int x, int y) { return CheckValidCell(x, y, packed); }) << ", rle "
+         << time_ns([&](int x, int y) { return CheckValidCell(x, y, rle); }) << "\n";
+
+    auto grid_scan = [&](int x, int y) {
+        while (y < cols && grid[x][y] != State::kObstacle)
+            y++;
+        return y;
+    };
+    expected = 0;
+    for (int i = 0; i < xs.size(); i++)
+        expected += grid_scan(xs[i], ys[i]);
+    cout << "  NextObstacle ns: grid scan " << time_ns(grid_scan) << ", packed "
+         << time_ns([&](int x, int y) { return packed.NextObstacle(x, y); }) << ", rle "
+         << time_ns([&](int x, int y) { return rle.NextObstacle(x, y); }) << "\n";
+    if (!agree)
+        cout << "  The boards gave different answers!\n";
+}
+
+#include "test.cpp"
+
+/**
+ * Pass .board or Moving AI .map files on the command line to add them to the
+ * memory report.
+ */
+int main(int argc, char *argv[])
+{
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    PackedBoard packed(board);
+    vector<vector<int>> path;
+    Search(packed, init, goal, path);
+    for (const auto &p : path)
+        board[p[0]][p[1]] = State::kPath;
+    board[init[0]][init[1]] = State::kStart;
+    board[goal[0]][goal[1]] = State::kFinish;
+    PrintBoard(board);
+    // Tests
+    TestCompressedCheckValidCell();
+    TestNextObstacle();
+    TestCompressedSearch();
+
+    cout << "==========================================================\n";
+    ReportBoard("1.board", ReadBoardFile("../files/1.board"));
+    for (int i = 1; i < argc; i++)
+    {
+        auto grid = ReadBoard(argv[i]);
+        if (grid.empty() || grid[0].empty())
+            cout << "Could not read " << argv[i] << "\n";
+        else
+            ReportBoard(argv[i], grid);
+    }
+    ReportBoard("Rooms", RoomsBoard(1024, 32));
+    ReportBoard("Random 20%", RandomBoard(1024, 0.2, 1));
+}
@@ -0,0 +1,115 @@
+void TestCompressedCheckValidCell()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Compressed CheckValidCell Test: ";
+    auto grid = RandomBoard(150, 0.3, 7);
+    PackedBoard packed(grid);
+    RleBoard rle(grid);
+    string failure;
+    for (int x = -1; x <= 150 && failure.empty(); x++)
+    {
+        for (int y = -1; y <= 150; y++)
+        {
+            bool expected = x >= 0 && x < 150 && y >= 0 && y < 150 && grid[x][y] != State::kObstacle;
+            if (CheckValidCell(x, y, packed) != expected || CheckValidCell(x, y, rle) != expected)
+            {
+                failure = "cell (" + std::to_string(x) + ", " + std::to_string(y) + ")";
+                break;
+            }
+        }
+    }
+
+    if (!failure.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Compressed boards disagree with the grid at " << failure << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestNextObstacle()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "NextObstacle Function Test: ";
+    // Long runs cross word boundaries; the scattered rows exercise short ones.
+    auto grid = RoomsBoard(300, 130);
+    auto noise = RandomBoard(300, 0.05, 3);
+    for (int x = 0; x < 300; x += 3)
+        grid[x] = noise[x];
+    PackedBoard packed(grid);
+    RleBoard rle(grid);
+    string failure;
+    for (int x = 0; x < 300 && failure.empty(); x++)
+    {
+        for (int y = 0; y <= 300; y++)
+        {
+            int expected = y;
+            while (expected < 300 && grid[x][expected] != State::kObstacle)
+                expected++;
+            if (packed.NextObstacle(x, y) != expected || rle.NextObstacle(x, y) != expected)
+            {
+                failure = "NextObstacle(" + std::to_string(x) + ", " + std::to_string(y) + ") = " +
+                          std::to_string(packed.NextObstacle(x, y)) + " / " + std::to_string(rle.NextObstacle(x, y)) +
+                          ", expected " + std::to_string(expected);
+                break;
+            }
+        }
+    }
+
+    if (!failure.empty())
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << failure << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    return;
+}
+
+void TestCompressedSearch()
+{
+    cout << "----------------------------------------------------------"
+         << "\n";
+    cout << "Compressed Search Test: ";
+    int init[2]{0, 0};
+    int goal[2]{4, 5};
+    auto board = ReadBoardFile("../files/1.board");
+    vector<vector<int>> packed_path, rle_path;
+    int packed_cost = Search(PackedBoard(board), init, goal, packed_path);
+    int rle_cost = Search(RleBoard(board), init, goal, rle_path);
+
+    if (packed_cost != 11 || rle_cost != 11 || packed_path.size() != 12 || rle_path.size() != 12)
+    {
+        cout << "failed"
+             << "\n";
+        cout << "\n"
+             << "Search on 1.board returned costs " << packed_cost << " (packed) and " << rle_cost
+             << " (rle), expected 11"
+             << "\n";
+        cout << "\n";
+    }
+    else
+    {
+        cout << "passed"
+             << "\n";
+    }
+    cout << "----------------------------------------------------------"
+         << "\n";
+    return;
+}
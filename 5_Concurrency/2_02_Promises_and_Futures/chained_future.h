@@ -0,0 +1,392 @@
+#ifndef CHAINED_FUTURE_H
+#define CHAINED_FUTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../2_03_Threads_vs_Tasks/thread_pool.h"
+
+// Future<T> and Promise<T> work like std::future and std::promise, but a
+// future can also be given a continuation with then(), and futures can be
+// combined with whenAll() and whenAny(). nothing blocks unless get() or
+// wait() is called.
+//
+// each then() allocates one shared state for the future it returns. the
+// continuation is stored inside that state, and the state is itself what
+// the previous stage calls when it completes. a chain therefore costs one
+// allocation per stage rather than one for the whole chain: its stages have
+// different types and are added one call at a time, so they cannot share a
+// block. a stage that runs on a pool also costs the pool's task, a
+// std::function and its captures, posted without a packaged_task or a
+// std::future. whenAll and whenAny keep their per-input callbacks inside
+// their own state.
+
+template <class T>
+class Future;
+template <class T>
+class Promise;
+
+namespace detail {
+
+// the value stored for a Future<void>
+struct Unit {};
+
+template <class T>
+using Stored = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+// what a continuation returns when given the value of a Future<T>
+template <class F, class T>
+struct ContinuationResult {
+  using type = std::invoke_result_t<F &, T>;
+};
+
+template <class F>
+struct ContinuationResult<F, void> {
+  using type = std::invoke_result_t<F &>;
+};
+
+template <class T>
+class State;
+
+// something to run once a State<T> is complete. executor is the pool to run
+// on, or nullptr to run inline on the thread that completes the state
+template <class T>
+class Callback {
+ public:
+  virtual ~Callback() = default;
+  virtual void fire(State<T> &completed) = 0;
+  ThreadPool *executor = nullptr;
+};
+
+template <class T>
+class State : public std::enable_shared_from_this<State<T>> {
+ public:
+  virtual ~State() = default;
+
+  void setValue(Stored<T> &&value) {
+    complete([&] { _value.emplace(std::move(value)); });
+  }
+
+  void setError(std::exception_ptr error) {
+    complete([&] { _error = error; });
+  }
+
+  // attach the one continuation this state will ever have; runs it now if
+  // the state is already complete
+  void setCallback(std::shared_ptr<Callback<T>> callback) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    if (!_ready) {
+      _callback = std::move(callback);
+      return;
+    }
+    uLock.unlock();
+    dispatch(std::move(callback));
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return _ready; });
+  }
+
+  bool isReady() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _ready;
+  }
+
+  // only valid once the state is complete
+  bool hasError() const { return _error != nullptr; }
+  std::exception_ptr error() const { return _error; }
+  Stored<T> takeValue() { return std::move(*_value); }
+
+ private:
+  template <class Set>
+  void complete(Set set) {
+    std::shared_ptr<Callback<T>> callback;
+    {
+      std::lock_guard<std::mutex> uLock(_mutex);
+      if (_ready) return;  // a state is completed only once
+      set();
+      _ready = true;
+      callback = std::move(_callback);
+    }
+    _cond.notify_all();
+    if (callback) dispatch(std::move(callback));
+  }
+
+  void dispatch(std::shared_ptr<Callback<T>> callback) {
+    if (ThreadPool *pool = callback->executor) {
+      // keep this state alive until the continuation has read it. fire()
+      // stores any exception in the next state, so nothing escapes the task
+      auto self = this->shared_from_this();
+      pool->post([callback, self] { callback->fire(*self); });
+    } else {
+      callback->fire(*this);
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  bool _ready = false;
+  std::optional<Stored<T>> _value;
+  std::exception_ptr _error;
+  std::shared_ptr<Callback<T>> _callback;
+};
+
+// complete `state` with the result of f(args...), or with its exception
+template <class U, class F, class... Args>
+void completeWith(State<U> &state, F &f, Args &&... args) {
+  try {
+    if constexpr (std::is_void_v<U>) {
+      f(std::forward<Args>(args)...);
+      state.setValue(Unit{});
+    } else {
+      state.setValue(f(std::forward<Args>(args)...));
+    }
+  } catch (...) {
+    state.setError(std::current_exception());
+  }
+}
+
+// the state of the future returned by then(): a State<U> that is also the
+// callback of the previous stage
+template <class T, class U, class F>
+class ThenState : public State<U>, public Callback<T> {
+ public:
+  explicit ThenState(F &&f) : _f(std::move(f)) {}
+
+  void fire(State<T> &completed) override {
+    if (completed.hasError())
+      this->setError(completed.error());
+    else if constexpr (std::is_void_v<T>)
+      completeWith(*this, _f);
+    else
+      completeWith(*this, _f, completed.takeValue());
+  }
+
+ private:
+  F _f;
+};
+
+// one callback per input of whenAll / whenAny, stored in the combined state
+template <class T, class Owner>
+class Slot : public Callback<T> {
+ public:
+  void fire(State<T> &completed) override { owner->onInput(index, completed); }
+  Owner *owner = nullptr;
+  std::size_t index = 0;
+};
+
+template <class T>
+class AllState : public State<std::vector<T>> {
+ public:
+  explicit AllState(std::size_t n) : _slots(n), _results(n), _pending(n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      _slots[i].owner = this;
+      _slots[i].index = i;
+    }
+  }
+
+  // a shared_ptr to slot i that keeps this whole state alive
+  std::shared_ptr<Callback<T>> slot(std::size_t i) {
+    return std::shared_ptr<Callback<T>>(this->shared_from_this(), &_slots[i]);
+  }
+
+  void onInput(std::size_t i, State<T> &completed) {
+    if (completed.hasError()) {
+      this->setError(completed.error());  // the first error wins
+      return;
+    }
+    _results[i].emplace(completed.takeValue());
+    if (_pending.fetch_sub(1) != 1) return;
+    std::vector<T> results;
+    results.reserve(_results.size());
+    for (auto &result : _results) results.push_back(std::move(*result));
+    this->setValue(std::move(results));
+  }
+
+ private:
+  std::vector<Slot<T, AllState>> _slots;
+  std::vector<std::optional<T>> _results;  // each written by one input
+  std::atomic<std::size_t> _pending;
+};
+
+template <class T>
+class AnyState : public State<std::pair<std::size_t, T>> {
+ public:
+  explicit AnyState(std::size_t n) : _slots(n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      _slots[i].owner = this;
+      _slots[i].index = i;
+    }
+  }
+
+  std::shared_ptr<Callback<T>> slot(std::size_t i) {
+    return std::shared_ptr<Callback<T>>(this->shared_from_this(), &_slots[i]);
+  }
+
+  // the first input to complete decides, whether with a value or an error
+  void onInput(std::size_t i, State<T> &completed) {
+    if (_decided.exchange(true)) return;
+    if (completed.hasError())
+      this->setError(completed.error());
+    else
+      this->setValue({i, completed.takeValue()});
+  }
+
+ private:
+  std::vector<Slot<T, AnyState>> _slots;
+  std::atomic<bool> _decided{false};
+};
+
+}  // namespace detail
+
+template <class T>
+class Future {
+ public:
+  Future() = default;
+
+  bool valid() const { return _state != nullptr; }
+  bool isReady() const { return _state->isReady(); }
+  void wait() const { _state->wait(); }
+
+  // block until the result is available; rethrows a stored exception. like
+  // std::future::get, this consumes the future
+  T get() {
+    auto state = std::move(_state);
+    state->wait();
+    if (state->hasError()) std::rethrow_exception(state->error());
+    if constexpr (!std::is_void_v<T>) return state->takeValue();
+  }
+
+  // f(value), or f() for a Future<void>, runs once this future completes,
+  // inline on the thread that completes it; the returned future holds f's
+  // result. an exception from this future or from f skips the rest of the
+  // chain up to get(). consumes this future
+  template <class F>
+  auto then(F f) {
+    return thenOn(nullptr, std::move(f));
+  }
+
+  // as above, but f runs on `pool`
+  template <class F>
+  auto then(ThreadPool &pool, F f) {
+    return thenOn(&pool, std::move(f));
+  }
+
+ private:
+  template <class U>
+  friend class Future;
+  friend class Promise<T>;
+  template <class U>
+  friend Future<std::vector<U>> whenAll(std::vector<Future<U>> futures);
+  template <class U>
+  friend Future<std::pair<std::size_t, U>> whenAny(
+      std::vector<Future<U>> futures);
+
+  explicit Future(std::shared_ptr<detail::State<T>> state)
+      : _state(std::move(state)) {}
+
+  template <class F>
+  auto thenOn(ThreadPool *pool, F f) {
+    using U = typename detail::ContinuationResult<F, T>::type;
+    auto next = std::make_shared<detail::ThenState<T, U, F>>(std::move(f));
+    next->executor = pool;
+    auto state = std::move(_state);
+    state->setCallback(next);
+    return Future<U>(std::move(next));
+  }
+
+  std::shared_ptr<detail::State<T>> _state;
+};
+
+template <class T>
+class Promise {
+ public:
+  Promise() : _state(std::make_shared<detail::State<T>>()) {}
+  Promise(Promise &&) = default;
+
+  Promise &operator=(Promise &&other) {
+    if (this != &other) {
+      abandon();
+      _state = std::move(other._state);
+      _satisfied = other._satisfied;
+    }
+    return *this;
+  }
+
+  // a promise dropped without a result breaks its future, as with
+  // std::promise
+  ~Promise() { abandon(); }
+
+  Future<T> getFuture() { return Future<T>(_state); }
+
+  // like std::promise, a second setValue or setException throws
+  // std::future_error with promise_already_satisfied
+  void setValue(detail::Stored<T> value) {
+    satisfy().setValue(std::move(value));
+  }
+
+  template <class V = T, std::enable_if_t<std::is_void_v<V>, int> = 0>
+  void setValue() {
+    setValue(detail::Unit{});
+  }
+
+  void setException(std::exception_ptr error) { satisfy().setError(error); }
+
+ private:
+  detail::State<T> &satisfy() {
+    if (!_state) throw std::future_error(std::future_errc::no_state);
+    if (_satisfied)
+      throw std::future_error(std::future_errc::promise_already_satisfied);
+    _satisfied = true;
+    return *_state;
+  }
+
+  void abandon() {
+    if (_state && !_satisfied)
+      _state->setError(std::make_exception_ptr(
+          std::future_error(std::future_errc::broken_promise)));
+  }
+
+  std::shared_ptr<detail::State<T>> _state;
+  bool _satisfied = false;
+};
+
+// a future for all the results, in input order. fails with the first
+// exception among the inputs
+template <class T>
+Future<std::vector<T>> whenAll(std::vector<Future<T>> futures) {
+  auto all = std::make_shared<detail::AllState<T>>(futures.size());
+  if (futures.empty()) all->setValue({});
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    auto state = std::move(futures[i]._state);
+    state->setCallback(all->slot(i));
+  }
+  return Future<std::vector<T>>(std::move(all));
+}
+
+// a future for the index and result of whichever input completes first.
+// with no inputs it fails at once, since nothing could ever complete it
+template <class T>
+Future<std::pair<std::size_t, T>> whenAny(std::vector<Future<T>> futures) {
+  auto any = std::make_shared<detail::AnyState<T>>(futures.size());
+  if (futures.empty())
+    any->setError(std::make_exception_ptr(
+        std::future_error(std::future_errc::no_state)));
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    auto state = std::move(futures[i]._state);
+    state->setCallback(any->slot(i));
+  }
+  return Future<std::pair<std::size_t, T>>(std::move(any));
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chained_future.h"
+
+// divideByNumber from example_4.cpp, on the chaining Promise
+void divideByNumber(Promise<double> &&prms, double num, double denom) {
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(500));  // simulate some work
+  try {
+    if (denom == 0)
+      throw std::runtime_error("Exception from thread: Division by zero!");
+    else
+      prms.setValue(num / denom);
+  } catch (...) {
+    prms.setException(std::current_exception());
+  }
+}
+
+// start divideByNumber on its own thread and return its future
+Future<double> divideAsync(std::vector<std::thread> &threads, double num,
+                           double denom) {
+  Promise<double> prms;
+  Future<double> ftr = prms.getFuture();
+  threads.emplace_back(divideByNumber, std::move(prms), num, denom);
+  return ftr;
+}
+
+int main() {
+  ThreadPool pool(2);
+  std::vector<std::thread> threads;
+
+  // a chain of continuations. main() does not wait for the division: the
+  // first step runs on the thread that sets the value, the second on the
+  // pool
+  Future<std::string> message =
+      divideAsync(threads, 42.0, 2.0)
+          .then([](double result) { return std::sqrt(result); })
+          .then(pool, [](double root) {
+            return "sqrt(42 / 2) = " + std::to_string(root);
+          });
+  std::cout << "Chain set up, main() is free to do other work\n";
+
+  // an exception set with setException skips the rest of the chain
+  Future<double> failed = divideAsync(threads, 42.0, 0.0).then([](double x) {
+    std::cout << "never printed\n";
+    return x;
+  });
+
+  // several divisions at once; the combined future fails if any of them do
+  std::vector<Future<double>> divisions;
+  for (double denom : {1.0, 2.0, 3.0})
+    divisions.push_back(divideAsync(threads, 42.0, denom));
+  Future<double> total =
+      whenAll(std::move(divisions)).then([](std::vector<double> results) {
+        double sum = 0;
+        for (double r : results) sum += r;
+        return sum;
+      });
+
+  // whichever of two divisions finishes first
+  std::vector<Future<double>> racers;
+  racers.push_back(divideAsync(threads, 1.0, 4.0));
+  racers.push_back(divideAsync(threads, 1.0, 8.0));
+  auto first = whenAny(std::move(racers));
+
+  std::cout << message.get() << std::endl;
+  try {
+    double result = failed.get();
+    std::cout << "Result = " << result << std::endl;
+  } catch (const std::runtime_error &e) {
+    std::cout << e.what() << std::endl;
+  }
+  std::cout << "42/1 + 42/2 + 42/3 = " << total.get() << std::endl;
+  auto [index, value] = first.get();
+  std::cout << "Division " << index << " finished first with " << value
+            << std::endl;
+
+  // thread barrier
+  for (auto &t : threads) t.join();
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+// same workload as example_3.cpp, but the result is returned so the
+// compiler cannot drop the loop, and nothing is printed per task
+double workerFunction(int n) {
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += sqrt(12345.6789 + i);
+  return sum;
+}
+
+// launch nTasks tasks with `launch` and wait for all of them; returns the
+// elapsed time in microseconds
+template <class Launch>
+int64_t timeTasks(Launch launch, int nTasks, int nLoops) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  std::vector<std::future<double>> futures;
+  for (int i = 0; i < nTasks; i++) futures.emplace_back(launch(nLoops));
+  double sum = 0;
+  for (auto &ftr : futures) sum += ftr.get();
+  auto t2 = std::chrono::high_resolution_clock::now();
+  double expected = 0;
+  for (int i = 0; i < nTasks; i++) expected += workerFunction(nLoops);
+  if (sum != expected) std::cout << "   wrong result!\n";
+  return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+      .count();
+}
+
+int main() {
+  // one thread per core, created once and reused by every case
+  ThreadPool pool;
+  std::cout << "Pool of " << pool.size() << " worker threads\n";
+
+  // the example_3.cpp cases, plus 1000 tiny tasks as in
+  // 3_02_Mutex_Protect_Shared_Data/example_2_mutex_type.cpp
+  std::vector<int> nLoops{1000000, 10, 10};
+  std::vector<int> nTasks{50, 50, 1000};
+
+  std::cout << "tasks   loops      async (us)   deferred (us)   pool (us)\n";
+  for (size_t c = 0; c < nLoops.size(); c++) {
+    int64_t async = timeTasks(
+        [](int n) { return std::async(std::launch::async, workerFunction, n); },
+        nTasks[c], nLoops[c]);
+    int64_t deferred = timeTasks(
+        [](int n) {
+          return std::async(std::launch::deferred, workerFunction, n);
+        },
+        nTasks[c], nLoops[c]);
+    int64_t pooled = timeTasks(
+        [&pool](int n) { return pool.submit(workerFunction, n); }, nTasks[c],
+        nLoops[c]);
+    std::cout << nTasks[c] << "\t" << nLoops[c] << "\t   " << async
+              << "\t\t" << deferred << "\t\t" << pooled << "\n";
+  }
+
+  // tasks that submit their own subtasks land on the worker's deque and are
+  // stolen by idle workers
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto outer = pool.submit([&pool] {
+    std::vector<std::future<double>> inner;
+    for (int i = 0; i < 1000; i++)
+      inner.push_back(pool.submit(workerFunction, 1000));
+    double sum = 0;
+    for (auto &ftr : inner) {
+      // help run queued tasks instead of blocking this worker
+      while (ftr.wait_for(std::chrono::seconds(0)) !=
+             std::future_status::ready)
+        if (!pool.runPending()) std::this_thread::yield();
+      sum += ftr.get();
+    }
+    return sum;
+  });
+  outer.get();
+  auto t2 = std::chrono::high_resolution_clock::now();
+  std::cout << "1000 nested tasks: "
+            << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+                   .count()
+            << " us\n";
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+// the workload of example_3.cpp, returning its result so the loop is kept
+double workerFunction(int n) {
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += sqrt(12345.6789 + i);
+  return sum;
+}
+
+// microseconds taken by f()
+template <class F>
+int64_t timeIt(F f) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  f();
+  auto t2 = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+      .count();
+}
+
+int main() {
+  ThreadPool &pool = sharedPool();
+  int nChunks = pool.size();
+
+  // uneven work: the heavy items of example_3.cpp are bunched at the start,
+  // so equal-count chunks give all of them to the first chunk
+  std::vector<int> nLoops(2000, 10);
+  for (int i = 0; i < 20; i++) nLoops[i] = 1000000;
+  int n = nLoops.size();
+
+  std::vector<double> expected(n), results(n);
+  int64_t sequential = timeIt([&] {
+    for (int i = 0; i < n; i++) expected[i] = workerFunction(nLoops[i]);
+  });
+
+  // split by hand into nChunks tasks of equal size, as in example_3.cpp
+  int64_t byHand = timeIt([&] {
+    std::vector<std::future<void>> futures;
+    for (int c = 0; c < nChunks; c++) {
+      futures.emplace_back(std::async(std::launch::async, [&, c] {
+        for (int i = c * n / nChunks; i < (c + 1) * n / nChunks; i++)
+          results[i] = workerFunction(nLoops[i]);
+      }));
+    }
+    for (auto &ftr : futures) ftr.wait();
+  });
+  bool byHandOk = results == expected;
+
+  // which thread ran each heavy item shows how well they were spread, even
+  // where there are too few cores for the times to show it
+  std::fill(results.begin(), results.end(), 0);
+  std::vector<std::thread::id> heavyRunBy(20);
+  int64_t forTime = timeIt([&] {
+    parallelFor(0, n, [&](int i) {
+      results[i] = workerFunction(nLoops[i]);
+      if (i < 20) heavyRunBy[i] = std::this_thread::get_id();
+    });
+  });
+  bool forOk = results == expected;
+  std::set<std::thread::id> heavyThreads(heavyRunBy.begin(), heavyRunBy.end());
+
+  double total = 0;
+  int64_t reduceTime = timeIt([&] {
+    total = parallelReduce(
+        0, n, 0.0, [&](int i) { return workerFunction(nLoops[i]); },
+        std::plus<double>());
+  });
+  double expectedTotal = 0;
+  for (double x : expected) expectedTotal += x;
+  bool reduceOk = std::abs(total - expectedTotal) <= 1e-9 * expectedTotal;
+
+  std::cout << n << " items, 20 heavy and " << n - 20 << " light, "
+            << pool.size() << " worker threads\n";
+  std::cout << "   sequential:                 " << sequential << " us\n";
+  std::cout << "   " << nChunks << " equal chunks with async:  " << byHand
+            << " us" << (byHandOk ? "" : "   wrong result!") << "\n";
+  std::cout << "   parallelFor:                " << forTime << " us"
+            << (forOk ? "" : "   wrong result!") << ", heavy items on "
+            << heavyThreads.size() << " threads\n";
+  std::cout << "   parallelReduce:             " << reduceTime << " us"
+            << (reduceOk ? "" : "   wrong result!") << "\n";
+  return 0;
+}
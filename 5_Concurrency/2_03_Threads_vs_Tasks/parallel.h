@@ -0,0 +1,160 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+#include "thread_pool.h"
+
+// one pool for the whole program, created on first use
+inline ThreadPool &sharedPool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+// a range is first cut into pieces of about this many indices when no
+// grain size is given: a few pieces per worker, so scheduling stays cheap
+// when the work is even. uneven work is balanced by splitting further on
+// demand, see parallelForRange
+template <class Index>
+Index autoGrain(ThreadPool &pool, Index begin, Index end) {
+  return std::max<Index>(1, (end - begin) / (8 * Index(pool.size())));
+}
+
+template <class Index, class Body>
+void parallelForRange(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const Body &body);
+
+// recursive halving: the right half becomes a pool task that an idle worker
+// may steal (and halve again), the left half is processed here. the halves
+// that nobody steals are picked up again by this thread while it waits
+template <class Index, class Body>
+void parallelForSplit(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const Body &body) {
+  Index mid = begin + (end - begin) / 2;
+  auto right = pool.submit([&pool, mid, end, grain, adaptive, &body] {
+    parallelForRange(pool, mid, end, grain, adaptive, body);
+  });
+  // the right half refers to body, so it must finish even if the left half
+  // throws
+  std::exception_ptr error;
+  try {
+    parallelForRange(pool, begin, mid, grain, adaptive, body);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  pool.wait(right);
+  if (error) std::rethrow_exception(error);
+}
+
+// pieces of at most `grain` indices run here. with `adaptive` set, the
+// thread looks for an idle worker after 1, 2, 4, 8, ... indices of a piece,
+// and if it finds one it halves what is left and offers the second half,
+// down to single indices. a few slow indices therefore spread over the pool
+// even when they all fall into the same piece, while a long piece of cheap
+// indices checks the pool only a few times
+template <class Index, class Body>
+void parallelForRange(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const Body &body) {
+  if (end - begin > grain)
+    return parallelForSplit(pool, begin, end, grain, adaptive, body);
+  Index i = begin;
+  for (Index step = 1; i < end; step *= 2) {
+    if (i > begin && end - i > 1 && pool.hasIdleWorkers())
+      return parallelForSplit(pool, i, end, grain, adaptive, body);
+    Index stop = adaptive && step < end - begin ? begin + step : end;
+    for (; i < stop; ++i) body(i);
+  }
+}
+
+// call body(i) for every i in [begin, end), spread over the pool. a grain
+// of 0 starts from autoGrain and splits further whenever a worker is idle;
+// a given grain is used as is. exceptions thrown by body propagate
+template <class Index, class Body>
+void parallelFor(ThreadPool &pool, Index begin, Index end, const Body &body,
+                 Index grain = 0) {
+  if (end <= begin) return;
+  bool adaptive = grain <= 0;
+  if (adaptive) grain = autoGrain(pool, begin, end);
+  parallelForRange(pool, begin, end, grain, adaptive, body);
+}
+
+template <class Index, class Body>
+void parallelFor(Index begin, Index end, const Body &body, Index grain = 0) {
+  parallelFor(sharedPool(), begin, end, body, grain);
+}
+
+template <class Index, class T, class Map, class Combine>
+T parallelReduceRange(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const T &identity, const Map &map,
+                      const Combine &combine);
+
+// the halving of parallelForSplit, combining the two halves in order
+template <class Index, class T, class Map, class Combine>
+T parallelReduceSplit(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const T &identity, const Map &map,
+                      const Combine &combine) {
+  Index mid = begin + (end - begin) / 2;
+  auto right = pool.submit([&pool, mid, end, grain, adaptive, &identity,
+                            &map, &combine] {
+    return parallelReduceRange(pool, mid, end, grain, adaptive, identity, map,
+                               combine);
+  });
+  std::exception_ptr error;
+  T left = identity;
+  try {
+    left = parallelReduceRange(pool, begin, mid, grain, adaptive, identity,
+                               map, combine);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  T rightResult = pool.wait(right);
+  if (error) std::rethrow_exception(error);
+  return combine(left, rightResult);
+}
+
+// the pieces of parallelForRange. a piece split on demand combines what it
+// has so far with the result of the rest, so the order is kept
+template <class Index, class T, class Map, class Combine>
+T parallelReduceRange(ThreadPool &pool, Index begin, Index end, Index grain,
+                      bool adaptive, const T &identity, const Map &map,
+                      const Combine &combine) {
+  if (end - begin > grain)
+    return parallelReduceSplit(pool, begin, end, grain, adaptive, identity,
+                               map, combine);
+  T result = identity;
+  Index i = begin;
+  for (Index step = 1; i < end; step *= 2) {
+    if (i > begin && end - i > 1 && pool.hasIdleWorkers())
+      return combine(result,
+                     parallelReduceSplit(pool, i, end, grain, adaptive,
+                                         identity, map, combine));
+    Index stop = adaptive && step < end - begin ? begin + step : end;
+    for (; i < stop; ++i) result = combine(result, map(i));
+  }
+  return result;
+}
+
+// combine(identity, map(begin), ..., map(end - 1)) computed in pieces on
+// the pool. combine must be associative and `identity` its neutral element;
+// the pieces are combined in index order, so combine need not commute. the
+// grain works as in parallelFor
+template <class Index, class T, class Map, class Combine>
+T parallelReduce(ThreadPool &pool, Index begin, Index end, const T &identity,
+                 const Map &map, const Combine &combine, Index grain = 0) {
+  if (end <= begin) return identity;
+  bool adaptive = grain <= 0;
+  if (adaptive) grain = autoGrain(pool, begin, end);
+  return parallelReduceRange(pool, begin, end, grain, adaptive, identity, map,
+                             combine);
+}
+
+template <class Index, class T, class Map, class Combine>
+T parallelReduce(Index begin, Index end, const T &identity, const Map &map,
+                 const Combine &combine, Index grain = 0) {
+  return parallelReduce(sharedPool(), begin, end, identity, map, combine,
+                        grain);
+}
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// work-stealing deque after Chase and Lev ("Dynamic Circular Work-Stealing
+// Deque", with the C11 memory orders of Le et al.). the owning thread pushes
+// and takes at the bottom like a stack; other threads steal from the top.
+// only a take and a steal racing for the very last element need a
+// compare-exchange, so the owner's common path is plain loads and stores
+template <class T>
+class ChaseLevDeque {
+ public:
+  explicit ChaseLevDeque(int64_t capacity = 256) {
+    int64_t size = 2;
+    while (size < capacity) size <<= 1;
+    _arrays.emplace_back(new Array(size));
+    _array.store(_arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  // owner only
+  void push(T item) {
+    int64_t b = _bottom.load(std::memory_order_relaxed);
+    int64_t t = _top.load(std::memory_order_acquire);
+    Array *a = _array.load(std::memory_order_relaxed);
+    if (b - t > a->size - 1) a = grow(a, t, b);
+    a->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // owner only; false if the deque is empty
+  bool take(T &item) {
+    int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    Array *a = _array.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = _top.load(std::memory_order_relaxed);
+    if (t > b) {
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    item = a->get(b);
+    if (t == b) {
+      // last element: race the thieves for it
+      bool won = _top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // any thread; false if the deque is empty or another thread got there
+  // first
+  bool steal(T &item) {
+    int64_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = _bottom.load(std::memory_order_acquire);
+    if (t >= b) return false;
+    Array *a = _array.load(std::memory_order_acquire);
+    T candidate = a->get(t);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return false;
+    item = candidate;
+    return true;
+  }
+
+  bool empty() const {
+    return _bottom.load(std::memory_order_relaxed) <=
+           _top.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // circular buffer of atomics, so a thief may read a slot while the owner
+  // writes another lap of it
+  struct Array {
+    explicit Array(int64_t n) : size(n), slots(new std::atomic<T>[n]) {}
+    T get(int64_t i) const {
+      return slots[i & (size - 1)].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T item) {
+      slots[i & (size - 1)].store(item, std::memory_order_relaxed);
+    }
+    const int64_t size;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  // thieves may still be reading the old array, so it is kept until the
+  // deque is destroyed rather than freed here
+  Array *grow(Array *old, int64_t t, int64_t b) {
+    _arrays.emplace_back(new Array(old->size * 2));
+    Array *a = _arrays.back().get();
+    for (int64_t i = t; i < b; ++i) a->put(i, old->get(i));
+    _array.store(a, std::memory_order_release);
+    return a;
+  }
+
+  alignas(64) std::atomic<int64_t> _top{0};
+  alignas(64) std::atomic<int64_t> _bottom{0};
+  std::atomic<Array *> _array;
+  std::vector<std::unique_ptr<Array>> _arrays;  // owner only
+};
+
+// fixed set of worker threads, each with its own ChaseLevDeque. tasks
+// submitted from a worker go to the bottom of that worker's deque, where it
+// picks them up again in LIFO order while they are still in cache; tasks
+// submitted from other threads go to a shared queue. a worker that runs out
+// of tasks steals from the top of another worker's deque and sleeps only
+// when there is nothing left anywhere
+class ThreadPool {
+ public:
+  explicit ThreadPool(
+      unsigned numThreads = std::max(1u, std::thread::hardware_concurrency()))
+      : _deques(std::max(1u, numThreads)) {
+    for (unsigned i = 0; i < _deques.size(); ++i)
+      _threads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+
+  // runs the tasks that are still queued, then joins the workers
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> uLock(_sleepMutex);
+      _stop = true;
+    }
+    _wake.notify_all();
+    for (auto &t : _threads) t.join();
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(_threads.size()); }
+
+  // run f(args...) on the pool; the future delivers its result or exception.
+  // a task that waits on the future of another task blocks its worker, so
+  // pool tasks should wait with wait() below instead of get()
+  template <class F, class... Args>
+  auto submit(F &&f, Args &&... args)
+      -> std::future<std::invoke_result_t<F, Args...>> {
+    using R = std::invoke_result_t<F, Args...>;
+    auto task = std::make_shared<std::packaged_task<R()>>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<R> ftr = task->get_future();
+    enqueue(new Task([task] { (*task)(); }));
+    return ftr;
+  }
+
+  // run f() on the pool without the packaged_task and future of submit,
+  // for callers that deliver the result themselves. f must not throw
+  template <class F>
+  void post(F &&f) {
+    enqueue(new Task(std::forward<F>(f)));
+  }
+
+  // run one queued task on the calling thread, if there is one. lets a
+  // thread that waits for pool results help instead of blocking
+  bool runPending() {
+    Task *task = findTask(_current == this ? _index : 0);
+    if (!task) return false;
+    run(task);
+    return true;
+  }
+
+  // the result of a pool task, running queued tasks until it is ready.
+  // safe to call from inside a pool task. a worker keeps looking for tasks
+  // while the result is pending, yielding between looks, so its thread
+  // stays useful to the pool. any other thread blocks on the future once
+  // nothing is queued, since the workers finish the task without it
+  template <class R>
+  R wait(std::future<R> &ftr) {
+    while (ftr.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready) {
+      if (runPending()) continue;
+      if (_current != this) {
+        ftr.wait();
+        break;
+      }
+      _stalled.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::yield();
+      _stalled.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return ftr.get();
+  }
+
+  // true if a worker has run out of tasks and none is queued for it. a
+  // long loop can then hand part of its remaining range to that worker
+  bool hasIdleWorkers() const {
+    return _queued.load(std::memory_order_relaxed) == 0 &&
+           _sleepers.load(std::memory_order_relaxed) +
+                   _stalled.load(std::memory_order_relaxed) >
+               0;
+  }
+
+ private:
+  using Task = std::function<void()>;
+
+  void enqueue(Task *task) {
+    _queued.fetch_add(1);
+    if (_current == this) {
+      _deques[_index].push(task);
+    } else {
+      std::lock_guard<std::mutex> uLock(_injectMutex);
+      _injected.push_back(task);
+    }
+    // pairs with the increment of _sleepers in workerLoop: either the
+    // sleeper sees our task, or we see the sleeper and wake it
+    if (_sleepers.load() > 0) {
+      std::lock_guard<std::mutex> uLock(_sleepMutex);
+      _wake.notify_one();
+    }
+  }
+
+  // own deque first, then the shared queue, then the other workers
+  Task *findTask(unsigned self) {
+    Task *task = nullptr;
+    if (_current == this && _deques[self].take(task)) return task;
+    {
+      std::lock_guard<std::mutex> uLock(_injectMutex);
+      if (!_injected.empty()) {
+        task = _injected.front();
+        _injected.pop_front();
+        return task;
+      }
+    }
+    for (unsigned i = 1; i <= _deques.size(); ++i) {
+      unsigned victim = (self + i) % _deques.size();
+      if (_current == this && victim == self) continue;
+      if (_deques[victim].steal(task)) return task;
+    }
+    return nullptr;
+  }
+
+  void run(Task *task) {
+    _queued.fetch_sub(1);
+    (*task)();
+    delete task;
+  }
+
+  void workerLoop(unsigned index) {
+    _current = this;
+    _index = index;
+    while (true) {
+      if (Task *task = findTask(index)) {
+        run(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> uLock(_sleepMutex);
+      _sleepers.fetch_add(1);
+      // _queued counts tasks that are queued but not yet started, so a
+      // nonzero value means some deque or the shared queue has one
+      _wake.wait(uLock, [this] { return _queued.load() > 0 || _stop; });
+      _sleepers.fetch_sub(1);
+      if (_stop && _queued.load() == 0) return;
+    }
+  }
+
+  std::vector<ChaseLevDeque<Task *>> _deques;
+  std::vector<std::thread> _threads;
+
+  std::mutex _injectMutex;
+  std::deque<Task *> _injected;
+
+  std::atomic<long> _queued{0};
+  std::atomic<int> _sleepers{0};
+  std::atomic<int> _stalled{0};  // workers in wait() with nothing to run
+  std::mutex _sleepMutex;
+  std::condition_variable _wake;
+  bool _stop = false;
+
+  // the pool and deque index of the calling thread, if it is a worker
+  static inline thread_local ThreadPool *_current = nullptr;
+  static inline thread_local unsigned _index = 0;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "profiled_mutex.h"
+
+class Vehicle {
+ public:
+  Vehicle(int id) : _id(id) {}
+  int getID() { return _id; }
+
+ private:
+  int _id;
+};
+
+// WaitingVehicles from example_2_mutex_type.cpp with the timed mutex
+// swapped for its profiled counterpart
+class WaitingVehicles {
+ public:
+  WaitingVehicles() {}
+
+  // getters / setters
+  void printSize() {
+    LOCK_SITE("WaitingVehicles::printSize");
+    std::lock_guard<ProfiledTimedMutex> lock(_mutex);
+    std::cout << "#vehicles = " << _vehicles.size() << std::endl;
+  }
+
+  // typical behaviour methods
+  void pushBack(Vehicle &&v) {
+    LOCK_SITE("WaitingVehicles::pushBack");
+    for (size_t i = 0; i < 3; ++i) {
+      if (_mutex.try_lock_for(std::chrono::milliseconds(100))) {
+        _vehicles.emplace_back(std::move(v));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        _mutex.unlock();
+        break;
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    }
+  }
+
+ private:
+  std::vector<Vehicle>
+      _vehicles;  // list of all vehicles waiting to enter this intersection
+  ProfiledTimedMutex _mutex;
+};
+
+// nanoseconds per uncontended lock/unlock pair
+template <class Mutex>
+double lockCost(Mutex &mutex) {
+  LOCK_SITE("lockCost benchmark");
+  const int n = 10000000;
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i) {
+    std::lock_guard<Mutex> lock(mutex);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t2 - t1).count() / n;
+}
+
+int main() {
+  // cost of the wrapper with profiling off and at two sampling rates
+  std::mutex plain;
+  ProfiledMutex<> profiled;
+  std::cout << "Uncontended lock/unlock:\n";
+  std::cout << "   std::mutex:                  " << lockCost(plain) << " ns\n";
+  std::cout << "   ProfiledMutex, off:          " << lockCost(profiled)
+            << " ns\n";
+  LockProfiler::enable(64, false);
+  std::cout << "   ProfiledMutex, 1 in 64:      " << lockCost(profiled)
+            << " ns\n";
+  LockProfiler::enable(1, false);
+  std::cout << "   ProfiledMutex, every lock:   " << lockCost(profiled)
+            << " ns\n";
+
+  // profile everything from here on and print the statistics at exit
+  LockProfiler::enable(1);
+
+  // four threads fighting over one counter
+  ProfiledMutex<> counterMutex;
+  long counter = 0;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      LOCK_SITE("counter increment");
+      for (int i = 0; i < 100000; ++i) {
+        std::lock_guard<ProfiledMutex<>> lock(counterMutex);
+        ++counter;
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+  std::cout << "counter = " << counter << std::endl;
+
+  // example_2_mutex_type.cpp with fewer vehicles
+  std::shared_ptr<WaitingVehicles> queue(new WaitingVehicles);
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 100; ++i) {
+    Vehicle v(i);
+    futures.emplace_back(std::async(
+        std::launch::async, &WaitingVehicles::pushBack, queue, std::move(v)));
+  }
+
+  std::for_each(futures.begin(), futures.end(),
+                [](std::future<void> &ftr) { ftr.wait(); });
+
+  queue->printSize();
+
+  return 0;
+}
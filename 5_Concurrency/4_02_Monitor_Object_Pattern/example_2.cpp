@@ -1,9 +1,19 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
 #include <future>
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
 class Vehicle {
  private:
@@ -19,32 +29,92 @@ class WaitingVehicles {
   std::vector<Vehicle>
       _vehicles;  // list of all vehicles waiting to enter this intersection
   std::mutex _mutex;
-  int _numVehicles;
+  std::condition_variable _cond;
+  // written under the mutex, read without it, so the read-mostly
+  // getNumVehicles and dataIsAvailable never wait for a writer
+  std::atomic<int> _numVehicles;
+  bool _closed;
+  // readable while a popBack would not block: its counter is the number of
+  // vehicles, plus one once the queue is closed
+  int _wakeupFd;
+
+  void signal(uint64_t count) {
+#ifdef __linux__
+    if (write(_wakeupFd, &count, sizeof(count)) != sizeof(count))
+      std::cerr << "eventfd write failed\n";
+#endif
+  }
 
- public:
-  WaitingVehicles() : _numVehicles(0) {}
+  // expects the lock to be held and a vehicle to be available
+  Vehicle take() {
+#ifdef __linux__
+    uint64_t count;
+    if (read(_wakeupFd, &count, sizeof(count)) != sizeof(count))
+      std::cerr << "eventfd read failed\n";
+#endif
+    // remove last vector element from queue
+    Vehicle v = std::move(_vehicles.back());
+    _vehicles.pop_back();
+    --_numVehicles;
 
-  int getNumVehicles() {
-    std::lock_guard<std::mutex> uLock(_mutex);
-    return _numVehicles;
+    // will not be copied due to return value optimization (RVO) in c++
+    return v;
+  }
+
+ public:
+  WaitingVehicles() : _numVehicles(0), _closed(false), _wakeupFd(-1) {
+#ifdef __linux__
+    // semaphore mode: every read takes one vehicle's worth off the counter
+    _wakeupFd = eventfd(0, EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
   }
 
-  bool dataIsAvailable() {
-    std::lock_guard<std::mutex> myLock(_mutex);
-    return !_vehicles.empty();
+  ~WaitingVehicles() {
+#ifdef __linux__
+    if (_wakeupFd >= 0) ::close(_wakeupFd);
+#endif
   }
 
-  Vehicle popBack() {
+  int getNumVehicles() { return _numVehicles.load(); }
+
+  // only a hint: another consumer may take the vehicle before this thread
+  // gets to it, so popBack and tryPopBack still check under the lock
+  bool dataIsAvailable() { return _numVehicles.load() > 0; }
+
+  // file descriptor for poll/epoll that is readable while tryPopBack would
+  // return a vehicle or the queue is closed; -1 where eventfd is missing
+  int wakeupFd() { return _wakeupFd; }
+
+  // wait until a vehicle is available and remove it; returns nothing once
+  // the queue is closed and empty
+  std::optional<Vehicle> popBack() {
     // perform vector modification under the lock
+    std::unique_lock<std::mutex> uLock(_mutex);
+    // sleep until pushBack or close notifies us, instead of spinning
+    _cond.wait(uLock, [this] { return !_vehicles.empty() || _closed; });
+    if (_vehicles.empty()) return std::nullopt;
+    return take();
+  }
+
+  // remove a vehicle if one is available, without waiting
+  std::optional<Vehicle> tryPopBack() {
     std::lock_guard<std::mutex> uLock(_mutex);
+    if (_vehicles.empty()) return std::nullopt;
+    return take();
+  }
 
-    // remove last vector element from queue
-    Vehicle v = std::move(_vehicles.back());
-    _vehicles.pop_back();
-    --_numVehicles;
+  bool isClosed() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _closed;
+  }
 
-    // will not be copied due to return value optimization (RVO) in c++
-    return v;
+  // no more vehicles will be added; wakes every waiting consumer
+  void close() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    if (_closed) return;
+    _closed = true;
+    signal(1);
+    _cond.notify_all();
   }
 
   void pushBack(Vehicle &&v) {
@@ -59,43 +129,99 @@ class WaitingVehicles {
 
     _vehicles.emplace_back(std::move(v));
     ++_numVehicles;
+    signal(1);
+    // wake up a consumer waiting in popBack
+    _cond.notify_one();
   }
 };
 
-int main() {
+// the original consumer: poll dataIsAvailable() in a tight loop
+void consumeByPolling(WaitingVehicles &queue, int numVehicles) {
+  int received = 0;
+  while (received < numVehicles) {
+    if (queue.dataIsAvailable()) {
+      Vehicle v = *queue.tryPopBack();
+      std::cout << " Vehicle #" << v.getID()
+                << " has been removed from the queue" << std::endl;
+      ++received;
+    }
+  }
+}
+
+// sleep in popBack until a vehicle arrives or the queue is closed
+void consumeByBlocking(WaitingVehicles &queue, int) {
+  while (std::optional<Vehicle> v = queue.popBack()) {
+    std::cout << " Vehicle #" << v->getID()
+              << " has been removed from the queue" << std::endl;
+  }
+}
+
+// sleep in epoll_wait on the queue's wakeup descriptor, as an event loop
+// that also watches sockets or timers would
+void consumeByEpoll(WaitingVehicles &queue, [[maybe_unused]] int numVehicles) {
+#ifdef __linux__
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  epoll_ctl(epollFd, EPOLL_CTL_ADD, queue.wakeupFd(), &event);
+  while (true) {
+    epoll_event ready;
+    if (epoll_wait(epollFd, &ready, 1, -1) < 1) continue;
+    while (std::optional<Vehicle> v = queue.tryPopBack()) {
+      std::cout << " Vehicle #" << v->getID()
+                << " has been removed from the queue" << std::endl;
+    }
+    if (queue.isClosed() && !queue.dataIsAvailable()) break;
+  }
+  ::close(epollFd);
+#else
+  consumeByBlocking(queue, numVehicles);
+#endif
+}
+
+// run the producers against one consumer; prints wall and CPU time
+void run(const char *name, void (*consume)(WaitingVehicles &, int)) {
   // create monitor object as a shared pointer to enable access by multiple
   // threads
   std::shared_ptr<WaitingVehicles> queue(new WaitingVehicles);
+  const int numVehicles = 10;
+
+  auto wallStart = std::chrono::steady_clock::now();
+  std::clock_t cpuStart = std::clock();
 
   std::cout << "Spawning threads...\n";
   std::vector<std::future<void>> futures;
-  for (int i = 0; i < 10; ++i) {
+  for (int i = 0; i < numVehicles; ++i) {
     // create a new Vehicle instance and move it into the queue
     Vehicle v(i);
     futures.emplace_back(std::async(
         std::launch::async, &WaitingVehicles::pushBack, queue, std::move(v)));
   }
 
-  std::cout << "Collecting results...\n";
-
-  while (true) {
-    if (queue->dataIsAvailable()) {
-      Vehicle v = queue->popBack();
-      std::cout << " Vehicle #" << v.getID()
-                << " has been removed from the queue" << std::endl;
-
-      if (queue->getNumVehicles() <= 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-        break;
-      }
-    }
-  }
+  // close the queue once every producer is done
+  std::thread closer([&futures, queue] {
+    std::for_each(futures.begin(), futures.end(),
+                  [](std::future<void> &ftr) { ftr.wait(); });
+    queue->close();
+  });
 
-  std::for_each(futures.begin(), futures.end(),
-                [](std::future<void> &ftr) { ftr.wait(); });
+  std::cout << "Collecting results...\n";
+  consume(*queue, numVehicles);
+  closer.join();
 
+  double wall = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - wallStart)
+                    .count();
+  double cpu = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
   std::cout << "Finished : " << queue->getNumVehicles()
             << " vehicle(s) left in the queue" << std::endl;
+  std::cout << name << ": " << wall << " ms wall time, " << cpu
+            << " ms CPU time\n\n";
+}
 
+int main() {
+  run("polling loop", consumeByPolling);
+  run("blocking popBack", consumeByBlocking);
+  run("epoll on wakeupFd", consumeByEpoll);
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class Vehicle {
+ public:
+  Vehicle(int id) : _id(id) {}
+  int getID() const { return _id; }
+
+ private:
+  int _id;
+};
+
+// what readers of WaitingVehicles ask for. numVehicles always equals
+// pushed - popped, so a reader can tell whether it saw a consistent snapshot
+struct VehicleStats {
+  int numVehicles;
+  long pushed;
+  long popped;
+};
+
+// sequence lock: a writer makes the sequence number odd, updates the value
+// and makes it even again; a reader copies the value and retries if the
+// sequence was odd or changed meanwhile. readers never write shared memory,
+// so they do not slow each other down. writers must be serialized by the
+// caller. the value is kept in atomic words, so a reader that races with a
+// writer reads stale words rather than causing a data race
+template <class T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SeqLock copies its value word by word");
+
+ public:
+  T load() const {
+    uint64_t words[kWords];
+    while (true) {
+      uint64_t before = _seq.load(std::memory_order_acquire);
+      if (before & 1) {
+        // a writer is in the middle of an update
+        std::this_thread::yield();
+        continue;
+      }
+      for (std::size_t i = 0; i < kWords; ++i)
+        words[i] = _words[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (_seq.load(std::memory_order_relaxed) == before) break;
+    }
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+  void store(const T &value) {
+    uint64_t words[kWords] = {};
+    std::memcpy(words, &value, sizeof(T));
+    uint64_t seq = _seq.load(std::memory_order_relaxed);
+    _seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWords; ++i)
+      _words[i].store(words[i], std::memory_order_relaxed);
+    _seq.store(seq + 2, std::memory_order_release);
+  }
+
+ private:
+  static constexpr std::size_t kWords = (sizeof(T) + 7) / 8;
+  std::atomic<uint64_t> _seq{0};
+  std::atomic<uint64_t> _words[kWords] = {};
+};
+
+// WaitingVehicles from example_2.cpp: one mutex for readers and writers
+class LockedVehicles {
+ public:
+  void pushBack(Vehicle &&v) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _vehicles.emplace_back(std::move(v));
+    ++_pushed;
+  }
+
+  bool tryPopBack() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    if (_vehicles.empty()) return false;
+    _vehicles.pop_back();
+    ++_popped;
+    return true;
+  }
+
+  VehicleStats getStats() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return {int(_vehicles.size()), _pushed, _popped};
+  }
+
+  bool hasVehicle(int id) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return contains(_vehicles, id);
+  }
+
+  static bool contains(const std::vector<Vehicle> &vehicles, int id) {
+    return std::any_of(vehicles.begin(), vehicles.end(),
+                       [id](const Vehicle &v) { return v.getID() == id; });
+  }
+
+ private:
+  std::mutex _mutex;
+  std::vector<Vehicle> _vehicles;
+  long _pushed = 0;
+  long _popped = 0;
+};
+
+// writers still take the mutex, but every counter is mirrored in an atomic
+// that readers load without locking. each counter is exact on its own;
+// several of them read one after another need not belong together
+class AtomicVehicles {
+ public:
+  void pushBack(Vehicle &&v) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _vehicles.emplace_back(std::move(v));
+    _pushed.store(_pushed.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+    _numVehicles.store(_vehicles.size(), std::memory_order_release);
+  }
+
+  bool tryPopBack() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    if (_vehicles.empty()) return false;
+    _vehicles.pop_back();
+    _numVehicles.store(_vehicles.size(), std::memory_order_release);
+    _popped.store(_popped.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+    return true;
+  }
+
+  int getNumVehicles() { return _numVehicles.load(std::memory_order_acquire); }
+  bool dataIsAvailable() { return getNumVehicles() > 0; }
+
+  VehicleStats getStats() {
+    return {_numVehicles.load(std::memory_order_acquire),
+            _pushed.load(std::memory_order_acquire),
+            _popped.load(std::memory_order_acquire)};
+  }
+
+  bool hasVehicle(int id) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return LockedVehicles::contains(_vehicles, id);
+  }
+
+ private:
+  std::mutex _mutex;
+  std::vector<Vehicle> _vehicles;
+  std::atomic<int> _numVehicles{0};
+  std::atomic<long> _pushed{0};
+  std::atomic<long> _popped{0};
+};
+
+// writers take the mutex and publish all counters together through a
+// seqlock, so readers get a consistent snapshot without locking
+class SeqlockVehicles {
+ public:
+  void pushBack(Vehicle &&v) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _vehicles.emplace_back(std::move(v));
+    ++_stats.pushed;
+    publish();
+  }
+
+  bool tryPopBack() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    if (_vehicles.empty()) return false;
+    _vehicles.pop_back();
+    ++_stats.popped;
+    publish();
+    return true;
+  }
+
+  int getNumVehicles() { return _published.load().numVehicles; }
+  bool dataIsAvailable() { return getNumVehicles() > 0; }
+  VehicleStats getStats() { return _published.load(); }
+
+  bool hasVehicle(int id) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return LockedVehicles::contains(_vehicles, id);
+  }
+
+ private:
+  // called with the mutex held, which also serializes the seqlock writers
+  void publish() {
+    _stats.numVehicles = _vehicles.size();
+    _published.store(_stats);
+  }
+
+  std::mutex _mutex;
+  std::vector<Vehicle> _vehicles;
+  VehicleStats _stats{0, 0, 0};
+  SeqLock<VehicleStats> _published;
+};
+
+// readers share a std::shared_mutex and only writers take it exclusively.
+// counters gain little from this, as a shared lock still writes to the
+// mutex; it pays off when readers hold the lock longer, as hasVehicle does
+class SharedVehicles {
+ public:
+  void pushBack(Vehicle &&v) {
+    std::unique_lock<std::shared_mutex> uLock(_mutex);
+    _vehicles.emplace_back(std::move(v));
+    ++_pushed;
+  }
+
+  bool tryPopBack() {
+    std::unique_lock<std::shared_mutex> uLock(_mutex);
+    if (_vehicles.empty()) return false;
+    _vehicles.pop_back();
+    ++_popped;
+    return true;
+  }
+
+  VehicleStats getStats() {
+    std::shared_lock<std::shared_mutex> sLock(_mutex);
+    return {int(_vehicles.size()), _pushed, _popped};
+  }
+
+  bool hasVehicle(int id) {
+    std::shared_lock<std::shared_mutex> sLock(_mutex);
+    return LockedVehicles::contains(_vehicles, id);
+  }
+
+ private:
+  std::shared_mutex _mutex;
+  std::vector<Vehicle> _vehicles;
+  long _pushed = 0;
+  long _popped = 0;
+};
+
+const int kVehicles = 256;
+const int kTotalOps = 1 << 20;
+
+struct RunResult {
+  double opsPerSecond;
+  long tornSnapshots;  // reads whose counters did not fit together
+};
+
+// `threads` threads share kTotalOps operations: 95% reads, 5% writes that
+// alternately add and remove a vehicle. reads either take a snapshot of
+// the counters or scan the vehicles
+template <class Queue>
+RunResult run(int threads, bool scan) {
+  Queue queue;
+  for (int i = 0; i < kVehicles; ++i) queue.pushBack(Vehicle(i));
+  std::atomic<long> torn{0};
+  std::atomic<long> sink{0};
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      long localTorn = 0, localSink = 0;
+      bool push = false;
+      for (int i = 0; i < kTotalOps / threads; ++i) {
+        if (i % 20 == 0) {
+          if (push)
+            queue.pushBack(Vehicle(t + i));
+          else
+            queue.tryPopBack();
+          push = !push;
+        } else if (scan) {
+          localSink += queue.hasVehicle(i % (2 * kVehicles));
+        } else {
+          VehicleStats s = queue.getStats();
+          if (s.numVehicles != s.pushed - s.popped) ++localTorn;
+          localSink += s.numVehicles;
+        }
+      }
+      torn += localTorn;
+      sink += localSink;
+    });
+  }
+  for (auto &w : workers) w.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return {(kTotalOps / threads) * threads / seconds, torn.load()};
+}
+
+template <class Queue>
+void printRow(const char *name, bool scan) {
+  std::cout << "   " << name;
+  long torn = 0;
+  for (int threads : {1, 4, 16, 64}) {
+    RunResult r = run<Queue>(threads, scan);
+    std::cout << "\t" << r.opsPerSecond / 1e6;
+    torn += r.tornSnapshots;
+  }
+  if (!scan) std::cout << "\t" << torn;
+  std::cout << "\n";
+}
+
+int main() {
+  std::cout << "95% reads / 5% writes, million ops/s at 1, 4, 16 and 64 "
+               "threads\n";
+  std::cout << "Reads take a snapshot of the counters (last column: torn "
+               "snapshots)\n";
+  printRow<LockedVehicles>("std::mutex   ", false);
+  printRow<AtomicVehicles>("atomics      ", false);
+  printRow<SeqlockVehicles>("seqlock      ", false);
+  printRow<SharedVehicles>("shared_mutex ", false);
+  std::cout << "Reads scan " << kVehicles << " vehicles\n";
+  printRow<LockedVehicles>("std::mutex   ", true);
+  printRow<SharedVehicles>("shared_mutex ", true);
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// MessageQueue from generic_message_queue.cpp without the simulated work,
+// plus batch operations that move many messages per lock acquisition
+template <class T>
+class MessageQueue {
+ public:
+  int getNumMessages() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _messages.size();
+  }
+
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    waitForMessages(uLock);
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    if (_waiting > 0) _cond.notify_one();
+  }
+
+  // move every element of `batch` into the queue under one lock and wake one
+  // waiting consumer per message, or all of them if there are more messages
+  // than waiters. a consumer can be asleep while the queue is non-empty (a
+  // message may have just woken someone else), so the wakeups must not
+  // depend on whether the queue was empty before
+  template <class Range>
+  void sendBatch(Range &&batch) {
+    auto first = std::make_move_iterator(std::begin(batch));
+    auto last = std::make_move_iterator(std::end(batch));
+    if (first == last) return;
+    std::lock_guard<std::mutex> uLock(_mutex);
+    std::size_t before = _messages.size();
+    _messages.insert(_messages.end(), first, last);
+    std::size_t added = _messages.size() - before;
+    if (added >= _waiting) {
+      if (_waiting > 0) _cond.notify_all();
+    } else {
+      for (std::size_t i = 0; i < added; ++i) _cond.notify_one();
+    }
+  }
+
+  // block until at least one message is queued, then move up to maxN of
+  // them to the end of `out` under one lock. returns how many were taken
+  int receiveBatch(int maxN, std::vector<T> &out) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    waitForMessages(uLock);
+    int n = std::min<int>(maxN, _messages.size());
+    auto last = _messages.begin() + n;
+    out.insert(out.end(), std::make_move_iterator(_messages.begin()),
+               std::make_move_iterator(last));
+    _messages.erase(_messages.begin(), last);
+    return n;
+  }
+
+ private:
+  // called with the lock held; counts the caller as waiting while it sleeps
+  void waitForMessages(std::unique_lock<std::mutex> &uLock) {
+    ++_waiting;
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    --_waiting;
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+  std::size_t _waiting = 0;  // consumers blocked in receive or receiveBatch
+};
+
+const int kProducers = 4;
+const int kMessagesPerProducer = 1 << 20;
+
+// producers send in batches of `batchSize` (1 means plain send) and one
+// consumer drains up to `batchSize` at a time; returns messages per second
+double messagesPerSecond(int batchSize) {
+  MessageQueue<int> queue;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p, batchSize] {
+      std::vector<int> batch;
+      for (int i = 0; i < kMessagesPerProducer; ++i) {
+        int msg = p * kMessagesPerProducer + i;
+        if (batchSize == 1) {
+          queue.send(std::move(msg));
+          continue;
+        }
+        batch.push_back(msg);
+        if (int(batch.size()) == batchSize || i == kMessagesPerProducer - 1) {
+          queue.sendBatch(batch);
+          batch.clear();
+        }
+      }
+    });
+  }
+
+  long sum = 0;
+  long total = long(kProducers) * kMessagesPerProducer;
+  std::vector<int> out;
+  for (long received = 0; received < total;) {
+    if (batchSize == 1) {
+      sum += queue.receive();
+      ++received;
+      continue;
+    }
+    out.clear();
+    received += queue.receiveBatch(batchSize, out);
+    for (int msg : out) sum += msg;
+  }
+  for (auto &t : producers) t.join();
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (sum != total * (total - 1) / 2) std::cout << "   messages were lost!\n";
+  return total / seconds;
+}
+
+int main() {
+  std::cout << kProducers << " producers, 1 consumer, "
+            << kProducers * kMessagesPerProducer << " ints\n";
+  for (int batchSize : {1, 8, 64, 512}) {
+    std::cout << "   batch " << batchSize << ": "
+              << messagesPerSecond(batchSize) << " messages/s\n";
+  }
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// what send does when the queue is full
+enum class OverflowPolicy {
+  kBlock,       // wait until a consumer makes room
+  kFail,        // leave the message with the caller and return false
+  kDropOldest,  // discard the message at the front to make room
+  kDropNewest   // discard the message being sent
+};
+
+struct QueueStats {
+  std::size_t highWaterMark = 0;  // largest size the queue has reached
+  long droppedOldest = 0;
+  long droppedNewest = 0;
+  long rejected = 0;  // sends that failed under kFail
+};
+
+// MessageQueue with a capacity limit. producers and consumers wait on
+// separate condition variables, so a send only wakes consumers and a
+// receive only wakes producers blocked on a full queue
+template <class T>
+class BoundedMessageQueue {
+ public:
+  BoundedMessageQueue(std::size_t capacity, OverflowPolicy policy)
+      : _capacity(std::max<std::size_t>(capacity, 1)), _policy(policy) {}
+
+  // returns true if the message was queued. under kFail a rejected message
+  // is not moved from, so the caller still owns it
+  bool send(T &&msg) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    if (_messages.size() == _capacity) {
+      switch (_policy) {
+        case OverflowPolicy::kBlock:
+          ++_blockedProducers;
+          _notFull.wait(uLock, [this] { return _messages.size() < _capacity; });
+          --_blockedProducers;
+          break;
+        case OverflowPolicy::kFail:
+          ++_stats.rejected;
+          return false;
+        case OverflowPolicy::kDropOldest:
+          _messages.pop_front();
+          ++_stats.droppedOldest;
+          break;
+        case OverflowPolicy::kDropNewest:
+          ++_stats.droppedNewest;
+          return false;
+      }
+    }
+    _messages.push_back(std::move(msg));
+    _stats.highWaterMark = std::max(_stats.highWaterMark, _messages.size());
+    uLock.unlock();
+    _notEmpty.notify_one();
+    return true;
+  }
+
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _notEmpty.wait(uLock, [this] { return !_messages.empty(); });
+    return pop(uLock);
+  }
+
+  // wait at most `timeout` for a message; empty if none arrived in time
+  template <class Rep, class Period>
+  std::optional<T> receiveFor(std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    if (!_notEmpty.wait_for(uLock, timeout,
+                            [this] { return !_messages.empty(); }))
+      return std::nullopt;
+    return pop(uLock);
+  }
+
+  int getNumMessages() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _messages.size();
+  }
+
+  QueueStats getStats() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _stats;
+  }
+
+ private:
+  // remove the front message and wake one blocked producer for the slot it
+  // frees. waking only on the full-to-not-full transition loses wakeups: a
+  // second pop before the first woken producer refills the queue would free
+  // another slot without waking anyone. releases the lock
+  T pop(std::unique_lock<std::mutex> &uLock) {
+    bool producerWaiting = _blockedProducers > 0;
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    uLock.unlock();
+    if (producerWaiting) _notFull.notify_one();
+    return msg;
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _notEmpty;
+  std::condition_variable _notFull;
+  std::deque<T> _messages;
+  const std::size_t _capacity;
+  const OverflowPolicy _policy;
+  QueueStats _stats;
+  int _blockedProducers = 0;  // senders waiting in send under kBlock
+};
+
+const char *policyName(OverflowPolicy policy) {
+  switch (policy) {
+    case OverflowPolicy::kBlock:
+      return "block       ";
+    case OverflowPolicy::kFail:
+      return "fail        ";
+    case OverflowPolicy::kDropOldest:
+      return "drop oldest ";
+    case OverflowPolicy::kDropNewest:
+      return "drop newest ";
+  }
+  return "";
+}
+
+int main() {
+  const int numMessages = 2000;
+  const std::size_t capacity = 64;
+  std::cout << "A fast producer sends " << numMessages
+            << " messages to a slow consumer through a queue of capacity "
+            << capacity << "\n";
+
+  for (auto policy :
+       {OverflowPolicy::kBlock, OverflowPolicy::kFail,
+        OverflowPolicy::kDropOldest, OverflowPolicy::kDropNewest}) {
+    BoundedMessageQueue<int> queue(capacity, policy);
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<bool> producerDone(false);
+    std::thread producer([&queue, &producerDone] {
+      for (int i = 0; i < numMessages; ++i) {
+        int message = i;
+        queue.send(std::move(message));
+      }
+      producerDone = true;
+    });
+
+    // the consumer runs until the producer has finished and the queue is
+    // drained. a quiet spell alone is no sign of the end: under kBlock the
+    // producer may just be slow to be scheduled
+    long received = 0;
+    while (!producerDone || queue.getNumMessages() > 0) {
+      if (!queue.receiveFor(std::chrono::milliseconds(100))) continue;
+      ++received;
+      // simulate some work
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    producer.join();
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    QueueStats stats = queue.getStats();
+    std::cout << "   " << policyName(policy) << "received " << received
+              << ", high-water mark " << stats.highWaterMark
+              << ", dropped oldest " << stats.droppedOldest
+              << ", dropped newest " << stats.droppedNewest << ", rejected "
+              << stats.rejected << ", " << seconds << " s\n";
+    if (received + stats.droppedOldest + stats.droppedNewest + stats.rejected !=
+        numMessages)
+      std::cout << "   messages were lost!\n";
+  }
+
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
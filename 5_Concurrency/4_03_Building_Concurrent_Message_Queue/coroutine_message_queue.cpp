@@ -0,0 +1,366 @@
+// needs C++20: g++ -std=c++20 -pthread coroutine_message_queue.cpp
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// a few threads that resume suspended coroutines
+class Executor {
+ public:
+  explicit Executor(int numThreads) {
+    for (int i = 0; i < numThreads; ++i)
+      _threads.emplace_back([this] { run(); });
+  }
+
+  // finishes the coroutines that are already scheduled, then joins
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> uLock(_mutex);
+      _stop = true;
+    }
+    _cond.notify_all();
+    for (auto &t : _threads) t.join();
+  }
+
+  void schedule(std::coroutine_handle<> handle) {
+    {
+      std::lock_guard<std::mutex> uLock(_mutex);
+      _ready.push_back(handle);
+    }
+    _cond.notify_one();
+  }
+
+ private:
+  void run() {
+    while (true) {
+      std::unique_lock<std::mutex> uLock(_mutex);
+      _cond.wait(uLock, [this] { return !_ready.empty() || _stop; });
+      if (_ready.empty()) return;
+      std::coroutine_handle<> handle = _ready.front();
+      _ready.pop_front();
+      uLock.unlock();
+      handle.resume();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<std::coroutine_handle<>> _ready;
+  bool _stop = false;
+  std::vector<std::thread> _threads;
+};
+
+template <class T = void>
+class Task;
+
+// promise parts shared by Task<T> and Task<void>. a task starts suspended
+// and, when it finishes, transfers control straight to the coroutine that
+// awaited it, if any
+class TaskPromiseBase {
+ public:
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      std::coroutine_handle<> next = handle.promise()._continuation;
+      return next ? next : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() { _error = std::current_exception(); }
+
+  std::coroutine_handle<> _continuation;
+  std::exception_ptr _error;
+};
+
+template <class T>
+class TaskPromise : public TaskPromiseBase {
+ public:
+  Task<T> get_return_object();
+  void return_value(T value) { _value.emplace(std::move(value)); }
+
+  T result() {
+    if (_error) std::rethrow_exception(_error);
+    return std::move(*_value);
+  }
+
+ private:
+  std::optional<T> _value;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+ public:
+  Task<void> get_return_object();
+  void return_void() {}
+
+  void result() {
+    if (_error) std::rethrow_exception(_error);
+  }
+};
+
+// owning handle to a lazily started coroutine. another coroutine starts it
+// with co_await and gets its result or exception; top-level code starts it
+// with start(). the coroutine frame lives until the Task is destroyed
+template <class T>
+class Task {
+ public:
+  using promise_type = TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit Task(Handle handle) : _handle(handle) {}
+  Task(Task &&other) : _handle(std::exchange(other._handle, nullptr)) {}
+  Task &operator=(Task &&other) {
+    if (this != &other) {
+      if (_handle) _handle.destroy();
+      _handle = std::exchange(other._handle, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (_handle) _handle.destroy();
+  }
+
+  // run on the calling thread until the first suspension
+  void start() { _handle.resume(); }
+  bool done() const { return _handle.done(); }
+
+  auto operator co_await() {
+    struct Awaiter {
+      Handle handle;
+      bool await_ready() { return handle.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+        handle.promise()._continuation = caller;
+        return handle;
+      }
+      T await_resume() { return handle.promise().result(); }
+    };
+    return Awaiter{_handle};
+  }
+
+ private:
+  Handle _handle;
+};
+
+template <class T>
+Task<T> TaskPromise<T>::get_return_object() {
+  return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+  return Task<void>(
+      std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// MessageQueue whose receive() suspends the calling coroutine instead of
+// blocking its thread. a suspended receiver costs one queue entry that
+// lives in its coroutine frame; send() hands the message straight to the
+// oldest receiver and schedules it on the executor
+template <class T>
+class AsyncMessageQueue {
+ public:
+  explicit AsyncMessageQueue(Executor &executor) : _executor(executor) {}
+
+  class ReceiveAwaiter {
+   public:
+    explicit ReceiveAwaiter(AsyncMessageQueue &queue) : _queue(queue) {}
+
+    bool await_ready() { return false; }
+
+    // take a queued message and carry on, or park until send() brings one
+    bool await_suspend(std::coroutine_handle<> handle) {
+      std::lock_guard<std::mutex> uLock(_queue._mutex);
+      if (!_queue._messages.empty()) {
+        _msg.emplace(std::move(_queue._messages.front()));
+        _queue._messages.pop_front();
+        return false;
+      }
+      _handle = handle;
+      _queue._receivers.push_back(this);
+      return true;
+    }
+
+    T await_resume() { return std::move(*_msg); }
+
+   private:
+    friend class AsyncMessageQueue;
+    AsyncMessageQueue &_queue;
+    std::coroutine_handle<> _handle;
+    std::optional<T> _msg;
+  };
+
+  // co_await queue.receive() yields the next message
+  ReceiveAwaiter receive() { return ReceiveAwaiter(*this); }
+
+  void send(T &&msg) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    if (_receivers.empty()) {
+      _messages.push_back(std::move(msg));
+      return;
+    }
+    ReceiveAwaiter *receiver = _receivers.front();
+    _receivers.pop_front();
+    receiver->_msg.emplace(std::move(msg));
+    uLock.unlock();
+    _executor.schedule(receiver->_handle);
+  }
+
+ private:
+  Executor &_executor;
+  std::mutex _mutex;
+  std::deque<T> _messages;
+  std::deque<ReceiveAwaiter *> _receivers;
+};
+
+// the mutex and condition variable queue from generic_message_queue.cpp,
+// without the simulated work and in FIFO order
+template <class T>
+class MessageQueue {
+ public:
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+};
+
+using Clock = std::chrono::steady_clock;
+
+struct Message {
+  int id;
+  Clock::time_point sent;
+};
+
+// virtual and resident size of this process in bytes
+std::pair<long, long> memoryUsage() {
+  long pages = 0, resident = 0;
+  std::ifstream("/proc/self/statm") >> pages >> resident;
+  return {pages * 4096, resident * 4096};
+}
+
+struct Result {
+  double virtualPerConsumer;   // bytes
+  double residentPerConsumer;  // bytes
+  double medianLatency;        // microseconds
+  double p99Latency;           // microseconds
+};
+
+// park `n` consumers, then send them one message at a time and wait for it
+// to be picked up; `spawn` creates the consumers and `send` sends one message
+template <class Spawn, class Send>
+Result measure(int n, std::atomic<int> &received,
+               std::vector<double> &latencies, Spawn spawn, Send send) {
+  auto before = memoryUsage();
+  spawn();
+  auto after = memoryUsage();
+  for (int i = 0; i < n; ++i) {
+    send(Message{i, Clock::now()});
+    received.wait(i);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return {double(after.first - before.first) / n,
+          double(after.second - before.second) / n, latencies[n / 2],
+          latencies[n * 99 / 100]};
+}
+
+void record(const Message &msg, std::vector<double> &latencies,
+            std::atomic<int> &received) {
+  latencies[msg.id] =
+      std::chrono::duration<double, std::micro>(Clock::now() - msg.sent)
+          .count();
+  received.fetch_add(1);
+  received.notify_one();
+}
+
+Task<> coroutineConsumer(AsyncMessageQueue<Message> &queue,
+                         std::vector<double> &latencies,
+                         std::atomic<int> &received) {
+  Message msg = co_await queue.receive();
+  record(msg, latencies, received);
+}
+
+void print(const char *name, int n, const Result &r) {
+  std::cout << "   " << name << n << " consumers: " << r.virtualPerConsumer
+            << " B virtual and " << r.residentPerConsumer
+            << " B resident each, latency median " << r.medianLatency
+            << " us, p99 " << r.p99Latency << " us\n";
+}
+
+int main() {
+  const int coroutines = 100000;
+  // 100k OS threads exceed the default per-user thread limit on most
+  // systems, so the thread side is measured with fewer consumers; the cost
+  // per consumer does not depend on how many there are
+  const int threads = 10000;
+
+  std::cout << "Consumers wait on a queue; messages are sent one at a time\n";
+  {
+    std::vector<double> latencies(coroutines);
+    std::atomic<int> received{0};
+    // declared before the executor, so the frames outlive its threads
+    std::vector<Task<>> consumers;
+    Executor executor(2);
+    AsyncMessageQueue<Message> queue(executor);
+    Result r = measure(
+        coroutines, received, latencies,
+        [&] {
+          consumers.reserve(coroutines);
+          for (int i = 0; i < coroutines; ++i) {
+            consumers.push_back(coroutineConsumer(queue, latencies, received));
+            consumers.back().start();
+          }
+        },
+        [&](Message msg) { queue.send(std::move(msg)); });
+    print("coroutine: ", coroutines, r);
+  }
+  {
+    std::vector<double> latencies(threads);
+    std::atomic<int> received{0};
+    MessageQueue<Message> queue;
+    std::vector<std::thread> consumers;
+    Result r = measure(
+        threads, received, latencies,
+        [&] {
+          for (int i = 0; i < threads; ++i)
+            consumers.emplace_back([&] {
+              record(queue.receive(), latencies, received);
+            });
+        },
+        [&](Message msg) { queue.send(std::move(msg)); });
+    for (auto &t : consumers) t.join();
+    print("thread:    ", threads, r);
+  }
+
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
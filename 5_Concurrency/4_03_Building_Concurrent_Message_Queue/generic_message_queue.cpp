@@ -1,20 +1,82 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <vector>
 
+// ordering policies for MessageQueue. each one stores the queued messages
+// and decides which of them the next receive gets
+
+// oldest message first
 template <class T>
-class MessageQueue {
+class FifoOrder {
  public:
-  MessageQueue() : _numMessages(0) {}
+  void push(T &&msg) { _messages.push_back(std::move(msg)); }
+  T pop() {
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+  bool empty() const { return _messages.empty(); }
+  std::size_t size() const { return _messages.size(); }
 
-  int getNumMessages() {
-    std::lock_guard<std::mutex> uLock(_mutex);
-    return _numMessages;
+ private:
+  std::deque<T> _messages;
+};
+
+// newest message first; old messages starve while new ones keep arriving
+template <class T>
+class LifoOrder {
+ public:
+  void push(T &&msg) { _messages.push_back(std::move(msg)); }
+  T pop() {
+    T msg = std::move(_messages.back());
+    _messages.pop_back();
+    return msg;
+  }
+  bool empty() const { return _messages.empty(); }
+  std::size_t size() const { return _messages.size(); }
+
+ private:
+  std::deque<T> _messages;
+};
+
+// greatest message by `Compare` first, like std::priority_queue. messages
+// are moved in and out of the heap rather than copied
+template <class T, class Compare = std::less<T>>
+class PriorityOrder {
+ public:
+  void push(T &&msg) {
+    _heap.push_back(std::move(msg));
+    std::push_heap(_heap.begin(), _heap.end(), _compare);
+  }
+  T pop() {
+    std::pop_heap(_heap.begin(), _heap.end(), _compare);
+    T msg = std::move(_heap.back());
+    _heap.pop_back();
+    return msg;
   }
+  bool empty() const { return _heap.empty(); }
+  std::size_t size() const { return _heap.size(); }
+
+ private:
+  std::vector<T> _heap;
+  Compare _compare;
+};
+
+template <class T, class Order = FifoOrder<T>>
+class MessageQueue {
+ public:
+  // reads the size mirror without taking the lock
+  int getNumMessages() { return _numMessages.load(); }
 
   T receive() {
     // perform queue modification under the lock
@@ -22,12 +84,24 @@ class MessageQueue {
     // pass  the unique lock to conidition variable
     _cond.wait(uLock, [this] { return !_messages.empty(); });
 
-    // remove last vector element from queue
-    T msg = std::move(_messages.back());
-    _messages.pop_back();
-    --_numMessages;
-    // will not be copied due to Return Value Optimization (RVO) in c++
-    return msg;
+    // remove the next message in the order given by the policy
+    return pop();
+  }
+
+  // take the next message if there is one, without waiting
+  std::optional<T> tryReceive() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    if (_messages.empty()) return std::nullopt;
+    return pop();
+  }
+
+  // wait at most `timeout` for a message; empty if none arrived in time
+  template <class Rep, class Period>
+  std::optional<T> receiveFor(std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    if (!_cond.wait_for(uLock, timeout, [this] { return !_messages.empty(); }))
+      return std::nullopt;
+    return pop();
   }
 
   void send(T &&msg) {
@@ -40,17 +114,25 @@ class MessageQueue {
     // add the vector to queue
     std::cout << "   Message " << msg << " has been sent to the queue.\n";
 
-    _messages.push_back(std::move(msg));
-    ++_numMessages;
+    _messages.push(std::move(msg));
+    _numMessages.store(_messages.size());
     // notify client after pushing new message into the vector
     _cond.notify_one();
   }
 
  private:
+  // expects the lock to be held. will not be copied due to Return Value
+  // Optimization (RVO) in c++
+  T pop() {
+    T msg = _messages.pop();
+    _numMessages.store(_messages.size());
+    return msg;
+  }
+
   std::mutex _mutex;
   std::condition_variable _cond;
-  std::deque<T> _messages;
-  int _numMessages;
+  Order _messages;
+  std::atomic<int> _numMessages{0};  // size of _messages, written under _mutex
 };
 
 int main() {
@@ -59,8 +141,9 @@ int main() {
   std::shared_ptr<MessageQueue<int>> queue(new MessageQueue<int>);
 
   std::cout << "Spawning threads...\n";
+  const int numMessages = 10;
   std::vector<std::future<void>> futures;
-  for (int i; i < 10; i++) {
+  for (int i = 0; i < numMessages; i++) {
     int message = i;
     futures.emplace_back(std::async(std::launch::async,
                                     &MessageQueue<int>::send, queue,
@@ -69,20 +152,31 @@ int main() {
 
   std::cout << "Collecting results...\n";
 
-  while (true) {
-    int message = queue->receive();
-    std::cout << "    Message #" << message
-              << " has been removed form the queue.\n";
-
-    if (queue->getNumMessages() <= 0) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(500));
-      break;
+  // instead of polling getNumMessages(), block until every message is in.
+  // a timeout only means the producers are slow, not that they are done
+  for (int received = 0; received < numMessages;) {
+    if (std::optional<int> message =
+            queue->receiveFor(std::chrono::seconds(1))) {
+      std::cout << "    Message #" << *message
+                << " has been removed form the queue.\n";
+      ++received;
+    } else {
+      std::cout << "    Still waiting for "
+                << numMessages - received << " messages...\n";
     }
   }
 
   std::for_each(futures.begin(), futures.end(),
                 [](std::future<void> &ftr) { ftr.wait(); });
 
+  // the same messages through a priority queue come out largest first
+  MessageQueue<int, PriorityOrder<int>> priorities;
+  for (int message : {3, 9, 1, 7}) priorities.send(std::move(message));
+  std::cout << "Priority order:";
+  while (std::optional<int> message = priorities.tryReceive())
+    std::cout << " " << *message;
+  std::cout << "\n";
+
   std::cout << "======================Finished!======================="
             << std::endl;
   return 0;
@@ -0,0 +1,303 @@
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+constexpr std::size_t kCacheLine = 64;
+
+// bounded multi-producer/multi-consumer queue after Dmitry Vyukov. every
+// slot carries a sequence number that says whose turn it is: a producer may
+// fill slot i when its sequence equals the producer's ticket, a consumer may
+// empty it when the sequence is ticket + 1. tickets are claimed with a
+// compare-exchange on the shared enqueue or dequeue position, and a slot is
+// handed over with a single release store of its sequence
+template <class T>
+class MpmcQueue {
+ public:
+  // capacity is rounded up to a power of two
+  explicit MpmcQueue(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1;
+    _slots = std::vector<Slot>(size);
+    _mask = size - 1;
+    for (std::size_t i = 0; i < size; ++i)
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bool trySend(T &&msg) {
+    std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = _slots[pos & _mask];
+      std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          slot.data = std::move(msg);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // full: the slot still holds last lap's message
+      } else {
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool tryReceive(T &msg) {
+    std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = _slots[pos & _mask];
+      std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          msg = std::move(slot.data);
+          // free the slot for the producer one lap ahead
+          slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // empty: the slot has not been filled this lap
+      } else {
+        pos = _dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct alignas(kCacheLine) Slot {
+    std::atomic<std::size_t> sequence;
+    T data;
+  };
+
+  std::vector<Slot> _slots;
+  std::size_t _mask;
+  alignas(kCacheLine) std::atomic<std::size_t> _enqueuePos{0};
+  alignas(kCacheLine) std::atomic<std::size_t> _dequeuePos{0};
+};
+
+// lets threads sleep until "something changed" without a mutex on the fast
+// path. the state word holds an epoch in its high half and the number of
+// registered waiters in its low half. a waiter registers, rechecks its
+// condition, and sleeps only if the epoch is still the one it read; notify
+// bumps the epoch first, so a change can never slip in between the check
+// and the sleep. notifyOne also counts one waiter out, so once every
+// sleeper has been woken notify is a fence and a load again, with no
+// syscall. a waiter may stay counted after another waiter's wakeup hit it;
+// that costs a spare wakeup later but never loses one
+class EventCount {
+ public:
+  uint32_t prepareWait() {
+    uint64_t state = _state.fetch_add(1, std::memory_order_seq_cst);
+    // order the registration before the caller's recheck of the queue,
+    // pairing with the fence in notify: either the recheck sees the new
+    // message or notify sees this waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return state >> 32;
+  }
+
+  // the recheck succeeded after all. once the epoch has moved, a notify may
+  // already have counted this waiter out, so leave the count alone then
+  void cancelWait(uint32_t epoch) {
+    uint64_t state = _state.load(std::memory_order_relaxed);
+    while ((state >> 32) == epoch && (state & kWaiters) != 0 &&
+           !_state.compare_exchange_weak(state, state - 1,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+  void wait(uint32_t epoch) {
+#ifdef __linux__
+    syscall(SYS_futex, epochWord(), FUTEX_WAIT_PRIVATE, epoch, nullptr,
+            nullptr, 0);
+#else
+    while ((_state.load(std::memory_order_acquire) >> 32) == epoch)
+      std::this_thread::yield();
+#endif
+  }
+
+  // wakes one waiter, for one new message or one free slot
+  void notifyOne() {
+    if (bumpEpoch([](uint64_t state) { return state - 1; })) wake(1);
+  }
+
+  // wakes every waiter; the ones that lose the race simply wait again
+  void notifyAll() {
+    if (bumpEpoch([](uint64_t state) { return state & ~kWaiters; }))
+      wake(INT_MAX);
+  }
+
+ private:
+  static constexpr uint64_t kWaiters = 0xffffffff;
+  static constexpr uint64_t kEpoch = uint64_t{1} << 32;
+
+  // new epoch and `countOut(state)` waiters; false if nobody was waiting
+  template <class CountOut>
+  bool bumpEpoch(CountOut countOut) {
+    // order the caller's queue update before the read of the waiter count
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t state = _state.load(std::memory_order_relaxed);
+    do {
+      if ((state & kWaiters) == 0) return false;
+    } while (!_state.compare_exchange_weak(state, countOut(state) + kEpoch,
+                                           std::memory_order_seq_cst));
+    return true;
+  }
+
+#ifdef __linux__
+  // the futex waits on the 32 bits of the epoch
+  uint32_t *epochWord() {
+    auto *halves = reinterpret_cast<uint32_t *>(&_state);
+    return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? halves + 1 : halves;
+  }
+
+  void wake(int count) {
+    syscall(SYS_futex, epochWord(), FUTEX_WAKE_PRIVATE, count, nullptr,
+            nullptr, 0);
+  }
+#else
+  void wake(int) {}
+#endif
+
+  static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                "the futex needs the bare state word");
+  std::atomic<uint64_t> _state{0};
+};
+
+// MpmcQueue with the blocking send/receive of MessageQueue: spin on the
+// lock-free operations for a while, then park on an EventCount until the
+// other side makes progress
+template <class T>
+class BlockingMpmcQueue {
+ public:
+  explicit BlockingMpmcQueue(std::size_t capacity) : _queue(capacity) {}
+
+  void send(T &&msg) {
+    while (!_queue.trySend(std::move(msg))) {
+      if (spin([&] { return _queue.trySend(std::move(msg)); })) break;
+      uint32_t epoch = _notFull.prepareWait();
+      if (_queue.trySend(std::move(msg))) {
+        _notFull.cancelWait(epoch);
+        break;
+      }
+      _notFull.wait(epoch);
+    }
+    _notEmpty.notifyOne();
+  }
+
+  T receive() {
+    T msg;
+    while (!_queue.tryReceive(msg)) {
+      if (spin([&] { return _queue.tryReceive(msg); })) break;
+      uint32_t epoch = _notEmpty.prepareWait();
+      if (_queue.tryReceive(msg)) {
+        _notEmpty.cancelWait(epoch);
+        break;
+      }
+      _notEmpty.wait(epoch);
+    }
+    _notFull.notifyOne();
+    return msg;
+  }
+
+ private:
+  // retry an operation a few times before parking; pointless on one core,
+  // where the thread we are waiting for cannot run while we spin
+  template <class Op>
+  static bool spin(Op op) {
+    static const int spins =
+        std::thread::hardware_concurrency() > 1 ? 100 : 0;
+    for (int i = 0; i < spins; ++i)
+      if (op()) return true;
+    return false;
+  }
+
+  MpmcQueue<T> _queue;
+  EventCount _notEmpty;
+  EventCount _notFull;
+};
+
+// the mutex and condition variable queue from generic_message_queue.cpp,
+// without the simulated work and in FIFO order
+template <class T>
+class MessageQueue {
+ public:
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+};
+
+// `threads` producers and as many consumers move `total` messages through
+// the queue; returns messages per second
+template <class Queue>
+double messagesPerSecond(Queue &queue, int threads, int total) {
+  int perThread = total / threads;
+  std::atomic<long> sum{0};
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&queue, t, perThread] {
+      for (int i = 0; i < perThread; ++i) queue.send(t * perThread + i);
+    });
+    workers.emplace_back([&queue, &sum, perThread] {
+      long local = 0;
+      for (int i = 0; i < perThread; ++i) local += queue.receive();
+      sum += local;
+    });
+  }
+  for (auto &w : workers) w.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  long n = long(perThread) * threads;
+  if (sum != n * (n - 1) / 2) std::cout << "   messages were lost!\n";
+  return n / seconds;
+}
+
+int main() {
+  const int total = 1 << 20;
+  std::cout << "Moving " << total
+            << " ints, producers = consumers = threads per side\n";
+  std::cout << "threads   MessageQueue (msg/s)   BlockingMpmcQueue (msg/s)\n";
+  for (int threads = 1; threads <= 32; threads *= 2) {
+    MessageQueue<int> mutexQueue;
+    BlockingMpmcQueue<int> lockFree(1024);
+    double mutexRate = messagesPerSecond(mutexQueue, threads, total);
+    double lockFreeRate = messagesPerSecond(lockFree, threads, total);
+    std::cout << "   " << threads << "\t\t" << mutexRate << "\t\t"
+              << lockFreeRate << "\n";
+  }
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed-size pool of reusable buffers. free slots are kept on a lock-free
+// stack of indices; the head carries a tag that changes on every pop, so a
+// slot that is popped and pushed back between our load and our
+// compare-exchange cannot fool us (ABA problem)
+template <class T>
+class BufferPool {
+ public:
+  // move-only owner of one pooled buffer. the buffer goes back to the pool
+  // when the handle is destroyed, on whichever thread that happens
+  class Handle {
+   public:
+    Handle() : _pool(nullptr), _index(0) {}
+    Handle(BufferPool *pool, uint32_t index) : _pool(pool), _index(index) {}
+    Handle(Handle &&other) : _pool(other._pool), _index(other._index) {
+      other._pool = nullptr;
+    }
+    Handle &operator=(Handle &&other) {
+      if (this != &other) {
+        release();
+        _pool = other._pool;
+        _index = other._index;
+        other._pool = nullptr;
+      }
+      return *this;
+    }
+    Handle(const Handle &) = delete;
+    Handle &operator=(const Handle &) = delete;
+    ~Handle() { release(); }
+
+    explicit operator bool() const { return _pool != nullptr; }
+    T &operator*() const { return _pool->_buffers[_index]; }
+    T *operator->() const { return &_pool->_buffers[_index]; }
+
+   private:
+    void release() {
+      if (_pool) _pool->push(_index);
+      _pool = nullptr;
+    }
+
+    BufferPool *_pool;
+    uint32_t _index;
+  };
+
+  explicit BufferPool(uint32_t capacity)
+      : _buffers(capacity), _next(capacity), _head(pack(kEmpty, 0)) {
+    for (uint32_t i = 0; i < capacity; ++i) push(i);
+  }
+
+  // borrow a buffer, or an empty handle if all of them are in use
+  Handle tryAcquire() {
+    uint64_t head = _head.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t index = static_cast<uint32_t>(head);
+      if (index == kEmpty) return Handle();
+      uint32_t next = _next[index].load(std::memory_order_relaxed);
+      if (_head.compare_exchange_weak(head, pack(next, tag(head) + 1),
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire))
+        return Handle(this, index);
+    }
+  }
+
+  // borrow a buffer, waiting for a consumer to return one if necessary
+  Handle acquire() {
+    while (true) {
+      Handle handle = tryAcquire();
+      if (handle) return handle;
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  static const uint32_t kEmpty = UINT32_MAX;
+
+  static uint64_t pack(uint32_t index, uint32_t tag) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+  }
+  static uint32_t tag(uint64_t head) { return head >> 32; }
+
+  void push(uint32_t index) {
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    do {
+      _next[index].store(static_cast<uint32_t>(head),
+                         std::memory_order_relaxed);
+    } while (!_head.compare_exchange_weak(head, pack(index, tag(head) + 1),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  std::vector<T> _buffers;
+  std::vector<std::atomic<uint32_t>> _next;
+  std::atomic<uint64_t> _head;
+};
+
+// message queue that moves handles instead of payloads. producers borrow a
+// buffer from the queue's pool, fill it in place and send the handle; the
+// buffer is recycled when the consumer drops it, so no payload memory is
+// allocated or freed after the pool has warmed up
+template <class T>
+class PooledMessageQueue {
+ public:
+  using Handle = typename BufferPool<T>::Handle;
+
+  explicit PooledMessageQueue(uint32_t poolSize) : _pool(poolSize) {}
+
+  Handle borrow() { return _pool.acquire(); }
+
+  void send(Handle &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+  Handle receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    Handle msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+ private:
+  // declared first so it is destroyed last, after any queued handles
+  BufferPool<T> _pool;
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<Handle> _messages;
+};
+
+// the plain queue from generic_message_queue.cpp, without the simulated work
+template <class T>
+class MessageQueue {
+ public:
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+};
+
+struct Frame {
+  int id;
+  std::vector<char> pixels;
+};
+
+const int kFrameBytes = 256 * 1024;
+const int kProducers = 4;
+const int kFramesPerProducer = 2000;
+
+void fill(Frame &frame, int id) {
+  frame.id = id;
+  // resize keeps the capacity of a recycled buffer, so this only allocates
+  // the first time a pooled frame is used
+  frame.pixels.resize(kFrameBytes);
+  std::fill(frame.pixels.begin(), frame.pixels.begin() + 64,
+            static_cast<char>(id));
+}
+
+// id of a received frame, or -1 if its contents do not match the id
+long check(const Frame &frame) {
+  return frame.pixels[63] == static_cast<char>(frame.id) ? frame.id : -1;
+}
+
+template <class Produce, class Consume>
+double framesPerSecond(Produce produce, Consume consume) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<void>> futures;
+  for (int p = 0; p < kProducers; ++p)
+    futures.emplace_back(std::async(std::launch::async, produce, p));
+  long checksum = 0;
+  for (int i = 0; i < kProducers * kFramesPerProducer; ++i)
+    checksum += consume();
+  for (auto &ftr : futures) ftr.wait();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  long n = kProducers * kFramesPerProducer;
+  if (checksum != n * (n - 1) / 2)
+    std::cout << "   frames were lost or corrupted!\n";
+  return kProducers * kFramesPerProducer / seconds;
+}
+
+int main() {
+  std::cout << "Sending " << kProducers * kFramesPerProducer << " frames of "
+            << kFrameBytes / 1024 << " KB from " << kProducers
+            << " producers...\n";
+
+  // every frame is allocated by a producer and freed by the consumer
+  MessageQueue<Frame> plain;
+  double plainRate = framesPerSecond(
+      [&plain](int p) {
+        for (int i = 0; i < kFramesPerProducer; ++i) {
+          Frame frame;
+          fill(frame, p * kFramesPerProducer + i);
+          plain.send(std::move(frame));
+        }
+      },
+      [&plain]() { return check(plain.receive()); });
+
+  // frames are borrowed from the pool and return to it after use
+  PooledMessageQueue<Frame> pooled(64);
+  double pooledRate = framesPerSecond(
+      [&pooled](int p) {
+        for (int i = 0; i < kFramesPerProducer; ++i) {
+          auto frame = pooled.borrow();
+          fill(*frame, p * kFramesPerProducer + i);
+          pooled.send(std::move(frame));
+        }
+      },
+      [&pooled]() { return check(*pooled.receive()); });
+
+  std::cout << "   MessageQueue<Frame>:       " << plainRate << " frames/s\n";
+  std::cout << "   PooledMessageQueue<Frame>: " << pooledRate
+            << " frames/s\n";
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,270 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t kCacheLine = 64;
+
+// message queue split into lanes, one per consumer, each with its own mutex
+// and condition variable. producers spread messages over the lanes, so
+// consumers only contend when one of them runs dry and steals from another
+// lane. the size of each lane is mirrored in an atomic, which lets
+// getNumMessages() add them up without taking any lock
+template <class T>
+class ShardedMessageQueue {
+ public:
+  explicit ShardedMessageQueue(std::size_t numLanes)
+      : _lanes(numLanes > 0 ? numLanes : 1) {}
+
+  // round-robin over the lanes. the cursor belongs to the queue, so a thread
+  // that sends to several queues still spreads over all lanes of each one
+  void send(T &&msg) {
+    std::size_t next = _next.fetch_add(1, std::memory_order_relaxed);
+    sendTo(next % _lanes.size(), std::move(msg));
+  }
+
+  // messages with equal keys go to the same lane, so they are received in
+  // the order they were sent unless a consumer steals one of them
+  template <class Key>
+  void send(const Key &key, T &&msg) {
+    sendTo(std::hash<Key>{}(key) % _lanes.size(), std::move(msg));
+  }
+
+  // called by the consumer that owns `lane`. takes from its own lane first,
+  // then steals from the others, and sleeps when all of them are empty.
+  // returns nothing once the queue is closed and drained
+  std::optional<T> receive(std::size_t lane) {
+    Lane &own = _lanes[lane % _lanes.size()];
+    while (true) {
+      std::optional<T> msg = tryPop(own);
+      if (msg) return msg;
+      msg = steal(lane);
+      if (msg) return msg;
+
+      std::unique_lock<std::mutex> uLock(own.mutex);
+      if (!own.messages.empty()) continue;
+      if (_closed.load()) {
+        if (getNumMessages() == 0) return std::nullopt;
+        continue;  // another lane still holds messages to steal
+      }
+      // a producer that finds this lane's owner asleep wakes it directly; a
+      // producer whose lane owner is busy wakes an idle consumer to steal.
+      // a message may land in a busy lane after steal() looked at it, so
+      // look at the other lanes again once `waiting` is set. both sides use
+      // seq_cst: either we see the producer's size, or it sees `waiting` and
+      // sets the hint, which it can only do after we are asleep
+      own.waiting.store(true);
+      if (othersHaveMessages(lane)) {
+        own.waiting.store(false);
+        uLock.unlock();
+        // wait for a busy lane's lock this time rather than spin past it
+        msg = steal(lane, true);
+        if (msg) return msg;
+        continue;
+      }
+      own.cond.wait(uLock, [&own, this] {
+        return !own.messages.empty() || own.stealHint || _closed.load();
+      });
+      own.stealHint = false;
+      own.waiting.store(false);
+    }
+  }
+
+  // wake every consumer; they return nothing once all lanes are empty
+  void close() {
+    _closed.store(true);
+    for (Lane &lane : _lanes) {
+      std::lock_guard<std::mutex> uLock(lane.mutex);
+      lane.cond.notify_all();
+    }
+  }
+
+  // sum of the lane sizes; exact only while no one sends or receives
+  int getNumMessages() {
+    long n = 0;
+    for (Lane &lane : _lanes) n += lane.size.load(std::memory_order_relaxed);
+    return static_cast<int>(n);
+  }
+
+  long getNumSteals() { return _steals.load(std::memory_order_relaxed); }
+
+ private:
+  struct alignas(kCacheLine) Lane {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<T> messages;
+    std::atomic<long> size{0};  // written under mutex, read without it
+    std::atomic<bool> waiting{false};  // owner is asleep on cond
+    bool stealHint = false;            // owner should look at other lanes
+  };
+
+  void sendTo(std::size_t index, T &&msg) {
+    Lane &lane = _lanes[index];
+    {
+      std::lock_guard<std::mutex> uLock(lane.mutex);
+      lane.messages.push_back(std::move(msg));
+      // seq_cst, paired with the waiting consumer in receive()
+      lane.size.store(lane.messages.size());
+      if (lane.waiting.load()) {
+        lane.cond.notify_one();
+        return;
+      }
+    }
+    // the owner is busy, so hand the message to someone who is not
+    for (std::size_t i = 1; i < _lanes.size(); ++i) {
+      Lane &idle = _lanes[(index + i) % _lanes.size()];
+      if (!idle.waiting.load()) continue;
+      std::lock_guard<std::mutex> uLock(idle.mutex);
+      idle.stealHint = true;
+      idle.cond.notify_one();
+      return;
+    }
+  }
+
+  std::optional<T> tryPop(Lane &lane) {
+    std::lock_guard<std::mutex> uLock(lane.mutex);
+    return popFront(lane);
+  }
+
+  bool othersHaveMessages(std::size_t thief) {
+    for (std::size_t i = 1; i < _lanes.size(); ++i)
+      if (_lanes[(thief + i) % _lanes.size()].size.load() > 0) return true;
+    return false;
+  }
+
+  // take a message from the first other lane that has one. unless `block`
+  // is set, lanes whose lock is held are skipped rather than waited for
+  std::optional<T> steal(std::size_t thief, bool block = false) {
+    for (std::size_t i = 1; i < _lanes.size(); ++i) {
+      Lane &victim = _lanes[(thief + i) % _lanes.size()];
+      if (victim.size.load(std::memory_order_relaxed) == 0) continue;
+      std::unique_lock<std::mutex> uLock(victim.mutex, std::defer_lock);
+      if (block)
+        uLock.lock();
+      else if (!uLock.try_lock())
+        continue;
+      std::optional<T> msg = popFront(victim);
+      if (msg) {
+        _steals.fetch_add(1, std::memory_order_relaxed);
+        return msg;
+      }
+    }
+    return std::nullopt;
+  }
+
+  // expects the lane's mutex to be held
+  static std::optional<T> popFront(Lane &lane) {
+    if (lane.messages.empty()) return std::nullopt;
+    std::optional<T> msg(std::move(lane.messages.front()));
+    lane.messages.pop_front();
+    lane.size.store(lane.messages.size(), std::memory_order_relaxed);
+    return msg;
+  }
+
+  std::vector<Lane> _lanes;
+  alignas(kCacheLine) std::atomic<std::size_t> _next{0};  // send() cursor
+  alignas(kCacheLine) std::atomic<long> _steals{0};
+  std::atomic<bool> _closed{false};
+};
+
+// the mutex and condition variable queue from generic_message_queue.cpp in
+// FIFO order, with the same receive/close interface as ShardedMessageQueue
+template <class T>
+class MessageQueue {
+ public:
+  std::optional<T> receive(std::size_t) {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty() || _closed; });
+    if (_messages.empty()) return std::nullopt;
+    std::optional<T> msg(std::move(_messages.front()));
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _closed = true;
+    _cond.notify_all();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+  bool _closed = false;
+};
+
+const int kProducers = 4;
+const int kMessagesPerProducer = 1 << 18;
+
+// kProducers producers and `consumers` consumers; returns messages per
+// second
+template <class Queue>
+double messagesPerSecond(Queue &queue, int consumers) {
+  std::atomic<long> sum{0};
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers, workers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < kMessagesPerProducer; ++i)
+        queue.send(p * kMessagesPerProducer + i);
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    workers.emplace_back([&queue, &sum, c] {
+      long local = 0;
+      while (std::optional<int> msg = queue.receive(c)) local += *msg;
+      sum += local;
+    });
+  }
+  for (auto &t : producers) t.join();
+  queue.close();
+  for (auto &t : workers) t.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  long n = long(kProducers) * kMessagesPerProducer;
+  if (sum != n * (n - 1) / 2) std::cout << "   messages were lost!\n";
+  return n / seconds;
+}
+
+int main() {
+  std::cout << kProducers << " producers send "
+            << kProducers * kMessagesPerProducer << " ints\n";
+  std::cout << "consumers   MessageQueue (msg/s)   ShardedMessageQueue (msg/s)"
+               "   steals\n";
+  for (int consumers = 1; consumers <= 16; consumers *= 2) {
+    MessageQueue<int> single;
+    ShardedMessageQueue<int> sharded(consumers);
+    double singleRate = messagesPerSecond(single, consumers);
+    double shardedRate = messagesPerSecond(sharded, consumers);
+    std::cout << "   " << consumers << "\t\t" << singleRate << "\t\t"
+              << shardedRate << "\t\t" << sharded.getNumSteals() << "\n";
+  }
+
+  // keyed sends put all messages of one key in the same lane, so they come
+  // out in the order they were sent, whichever consumer takes them
+  ShardedMessageQueue<int> keyed(4);
+  for (int i = 0; i < 8; ++i) keyed.send(std::string("sensor-1"), int(i));
+  std::cout << "Messages for key sensor-1:";
+  while (keyed.getNumMessages() > 0) std::cout << " " << *keyed.receive(0);
+  std::cout << "\n";
+
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// keeps members that are written by different threads on different cache
+// lines, so the producer and the consumer do not invalidate each other
+constexpr std::size_t kCacheLine = 64;
+
+// bounded queue for exactly one producer thread and one consumer thread.
+// the producer only writes _tail and the consumer only writes _head; a
+// release store of one index paired with an acquire load by the other side
+// is all the synchronization a message needs. each side also keeps a
+// private copy of the other side's index and only rereads the shared one
+// when that copy says the ring is full (or empty)
+template <class T>
+class SpscRingBuffer {
+ public:
+  // capacity is rounded up to a power of two
+  explicit SpscRingBuffer(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) size <<= 1;
+    _slots.resize(size);
+    _mask = size - 1;
+  }
+
+  int getNumMessages() {
+    return static_cast<int>(_tail.load(std::memory_order_acquire) -
+                            _head.load(std::memory_order_acquire));
+  }
+
+  void send(T &&msg) {
+    std::size_t tail = _tail.load(std::memory_order_relaxed);
+    // wait for the consumer to free a slot
+    while (tail - _cachedHead == _slots.size()) {
+      _cachedHead = _head.load(std::memory_order_acquire);
+      if (tail - _cachedHead == _slots.size()) std::this_thread::yield();
+    }
+    _slots[tail & _mask] = std::move(msg);
+    _tail.store(tail + 1, std::memory_order_release);
+
+    // wake the consumer if it went to sleep on an empty ring. the fence
+    // orders our store to _tail before the load of _sleeping, pairing with
+    // the fence in waitForMessage
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> uLock(_mutex);
+      _cond.notify_one();
+    }
+  }
+
+  T receive() {
+    std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _cachedTail) {
+      _cachedTail = _tail.load(std::memory_order_acquire);
+      if (head == _cachedTail) waitForMessage(head);
+    }
+    T msg = std::move(_slots[head & _mask]);
+    _head.store(head + 1, std::memory_order_release);
+    return msg;
+  }
+
+ private:
+  // spin briefly, since the producer is usually about to deliver, then sleep
+  // on the condition variable until it does. on a single core the producer
+  // cannot run while we spin, so go straight to sleep there
+  void waitForMessage(std::size_t head) {
+    static const int spins =
+        std::thread::hardware_concurrency() > 1 ? 1000 : 0;
+    for (int spin = 0; spin < spins; ++spin) {
+      _cachedTail = _tail.load(std::memory_order_acquire);
+      if (head != _cachedTail) return;
+    }
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    _cond.wait(uLock, [this, head] {
+      _cachedTail = _tail.load(std::memory_order_acquire);
+      return head != _cachedTail;
+    });
+    _sleeping.store(false, std::memory_order_relaxed);
+  }
+
+  std::vector<T> _slots;
+  std::size_t _mask;
+
+  // written by the consumer
+  alignas(kCacheLine) std::atomic<std::size_t> _head{0};
+  std::size_t _cachedTail = 0;
+
+  // written by the producer
+  alignas(kCacheLine) std::atomic<std::size_t> _tail{0};
+  std::size_t _cachedHead = 0;
+
+  // only used when the consumer has to sleep
+  alignas(kCacheLine) std::atomic<bool> _sleeping{false};
+  std::mutex _mutex;
+  std::condition_variable _cond;
+};
+
+// the mutex and condition variable queue from generic_message_queue.cpp,
+// without the simulated work and in FIFO order
+template <class T>
+class MessageQueue {
+ public:
+  int getNumMessages() {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    return _messages.size();
+  }
+
+  T receive() {
+    std::unique_lock<std::mutex> uLock(_mutex);
+    _cond.wait(uLock, [this] { return !_messages.empty(); });
+    T msg = std::move(_messages.front());
+    _messages.pop_front();
+    return msg;
+  }
+
+  void send(T &&msg) {
+    std::lock_guard<std::mutex> uLock(_mutex);
+    _messages.push_back(std::move(msg));
+    _cond.notify_one();
+  }
+
+ private:
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<T> _messages;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// one producer streams n messages to one consumer
+template <class Queue>
+double messagesPerSecond(Queue &queue, int n) {
+  auto start = Clock::now();
+  std::thread producer([&queue, n] {
+    for (int i = 0; i < n; ++i) queue.send(int(i));
+  });
+  long sum = 0;
+  for (int i = 0; i < n; ++i) sum += queue.receive();
+  producer.join();
+  if (sum != long(n) * (n - 1) / 2) std::cout << "   messages were lost!\n";
+  return n / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// a message bounces between two threads through a pair of queues; returns
+// the median one-way latency in nanoseconds
+template <class Queue>
+double pingPongLatency(Queue &ping, Queue &pong, int rounds) {
+  std::thread echo([&] {
+    for (int i = 0; i < rounds; ++i) pong.send(ping.receive());
+  });
+  std::vector<double> samples;
+  for (int i = 0; i < rounds; ++i) {
+    auto t1 = Clock::now();
+    ping.send(int(i));
+    pong.receive();
+    samples.push_back(
+        std::chrono::duration<double, std::nano>(Clock::now() - t1).count() /
+        2);
+  }
+  echo.join();
+  std::nth_element(samples.begin(), samples.begin() + rounds / 2,
+                   samples.end());
+  return samples[rounds / 2];
+}
+
+int main() {
+  const int n = 5000000;
+  const int rounds = 20000;
+
+  MessageQueue<int> mutexQueue;
+  SpscRingBuffer<int> ring(1024);
+  double mutexRate = messagesPerSecond(mutexQueue, n);
+  double ringRate = messagesPerSecond(ring, n);
+
+  MessageQueue<int> mutexPing, mutexPong;
+  SpscRingBuffer<int> ringPing(1024), ringPong(1024);
+  double mutexLatency = pingPongLatency(mutexPing, mutexPong, rounds);
+  double ringLatency = pingPongLatency(ringPing, ringPong, rounds);
+
+  std::cout << "Streaming " << n << " ints from one producer to one consumer\n";
+  std::cout << "   MessageQueue:   " << mutexRate << " messages/s\n";
+  std::cout << "   SpscRingBuffer: " << ringRate << " messages/s\n";
+  std::cout << "Median one-way latency over " << rounds << " round trips\n";
+  std::cout << "   MessageQueue:   " << mutexLatency << " ns\n";
+  std::cout << "   SpscRingBuffer: " << ringLatency << " ns\n";
+  std::cout << "======================Finished!======================="
+            << std::endl;
+  return 0;
+}